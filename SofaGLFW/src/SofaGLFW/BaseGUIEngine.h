@@ -41,6 +41,10 @@ public:
     virtual void afterDraw() = 0;
     virtual void terminate() = 0;
     virtual bool dispatchMouseEvents() = 0;
+
+    /// Returns true if the engine still displays the image of the scene drawn during a previous frame,
+    /// so that drawing the scene again can be skipped if nothing changed since then
+    virtual bool canReuseLastSceneImage() const { return false; }
 };
 
 } // namespace sofaglfw
@@ -0,0 +1,216 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaGLFW/SofaGLFWAllocationTracker.h>
+
+#include <array>
+#include <cstdlib>
+#include <new>
+
+#if SOFAGLFW_ENABLE_ALLOCATION_TRACKER == 1
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+#endif // SOFAGLFW_ENABLE_ALLOCATION_TRACKER == 1
+
+namespace sofaglfw
+{
+
+namespace
+{
+    bool s_isEnabled { false };
+
+    /// Only the thread which opened a scope counts its allocations
+    thread_local SofaGLFWAllocationTracker::Scope t_currentScope { SofaGLFWAllocationTracker::Scope::NbScopes };
+
+    struct ScopeState
+    {
+        SofaGLFWAllocationTracker::Counters current;
+        SofaGLFWAllocationTracker::Counters last;
+        std::uint64_t nbCompletedScopes {};
+        std::int64_t liveBytes {};
+    };
+    std::array<ScopeState, static_cast<std::size_t>(SofaGLFWAllocationTracker::Scope::NbScopes)> s_scopes;
+
+#if SOFAGLFW_ENABLE_ALLOCATION_TRACKER == 1
+    std::size_t allocatedSize(void* pointer) noexcept
+    {
+#if defined(_WIN32)
+        return _msize(pointer);
+#elif defined(__APPLE__)
+        return malloc_size(pointer);
+#else
+        return malloc_usable_size(pointer);
+#endif
+    }
+
+    void* allocate(std::size_t size)
+    {
+        if (size == 0)
+        {
+            size = 1;
+        }
+        while (true)
+        {
+            if (void* pointer = std::malloc(size))
+            {
+                SofaGLFWAllocationTracker::onAllocation(pointer);
+                return pointer;
+            }
+            const std::new_handler handler = std::get_new_handler();
+            if (!handler)
+            {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void deallocate(void* pointer) noexcept
+    {
+        if (pointer)
+        {
+            SofaGLFWAllocationTracker::onDeallocation(pointer);
+            std::free(pointer);
+        }
+    }
+#endif // SOFAGLFW_ENABLE_ALLOCATION_TRACKER == 1
+}
+
+bool SofaGLFWAllocationTracker::isAvailable()
+{
+    return SOFAGLFW_ENABLE_ALLOCATION_TRACKER == 1;
+}
+
+void SofaGLFWAllocationTracker::setEnabled(const bool isEnabled)
+{
+    s_isEnabled = isEnabled && isAvailable();
+}
+
+bool SofaGLFWAllocationTracker::isEnabled()
+{
+    return s_isEnabled;
+}
+
+void SofaGLFWAllocationTracker::begin(const Scope scope)
+{
+    // the scopes are not nested: an allocation is attributed to a single scope
+    if (!s_isEnabled || t_currentScope != Scope::NbScopes)
+    {
+        return;
+    }
+
+    auto& state = s_scopes[static_cast<std::size_t>(scope)];
+    state.current = Counters{};
+    state.liveBytes = 0;
+    t_currentScope = scope;
+}
+
+void SofaGLFWAllocationTracker::end(const Scope scope)
+{
+    if (t_currentScope != scope)
+    {
+        return;
+    }
+
+    t_currentScope = Scope::NbScopes;
+    auto& state = s_scopes[static_cast<std::size_t>(scope)];
+    state.last = state.current;
+    ++state.nbCompletedScopes;
+}
+
+SofaGLFWAllocationTracker::Counters SofaGLFWAllocationTracker::getLastCounters(const Scope scope)
+{
+    return s_scopes[static_cast<std::size_t>(scope)].last;
+}
+
+std::uint64_t SofaGLFWAllocationTracker::getNbCompletedScopes(const Scope scope)
+{
+    return s_scopes[static_cast<std::size_t>(scope)].nbCompletedScopes;
+}
+
+void SofaGLFWAllocationTracker::onAllocation(void* pointer) noexcept
+{
+#if SOFAGLFW_ENABLE_ALLOCATION_TRACKER == 1
+    if (t_currentScope == Scope::NbScopes)
+    {
+        return;
+    }
+
+    auto& state = s_scopes[static_cast<std::size_t>(t_currentScope)];
+    const auto size = allocatedSize(pointer);
+    ++state.current.nbAllocations;
+    state.current.allocatedBytes += size;
+    state.liveBytes += static_cast<std::int64_t>(size);
+    if (state.liveBytes > 0 && static_cast<std::uint64_t>(state.liveBytes) > state.current.peakLiveBytes)
+    {
+        state.current.peakLiveBytes = static_cast<std::uint64_t>(state.liveBytes);
+    }
+#else
+    (void)pointer;
+#endif
+}
+
+void SofaGLFWAllocationTracker::onDeallocation(void* pointer) noexcept
+{
+#if SOFAGLFW_ENABLE_ALLOCATION_TRACKER == 1
+    if (t_currentScope == Scope::NbScopes)
+    {
+        return;
+    }
+
+    auto& state = s_scopes[static_cast<std::size_t>(t_currentScope)];
+    const auto size = allocatedSize(pointer);
+    ++state.current.nbDeallocations;
+    state.current.freedBytes += size;
+    state.liveBytes -= static_cast<std::int64_t>(size);
+#else
+    (void)pointer;
+#endif
+}
+
+} // namespace sofaglfw
+
+#if SOFAGLFW_ENABLE_ALLOCATION_TRACKER == 1
+// Replacement of the global allocation functions. The aligned versions are left to the standard library.
+void* operator new(std::size_t size) { return sofaglfw::allocate(size); }
+void* operator new[](std::size_t size) { return sofaglfw::allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return sofaglfw::allocate(size); }
+    catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return sofaglfw::allocate(size); }
+    catch (...) { return nullptr; }
+}
+void operator delete(void* pointer) noexcept { sofaglfw::deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { sofaglfw::deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { sofaglfw::deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { sofaglfw::deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { sofaglfw::deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { sofaglfw::deallocate(pointer); }
+#endif // SOFAGLFW_ENABLE_ALLOCATION_TRACKER == 1
@@ -0,0 +1,88 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaGLFW/config.h>
+
+#include <cstdint>
+
+namespace sofaglfw
+{
+
+/**
+ * Counts the heap allocations of the main thread during the simulation steps and during the GUI
+ * frames, to find the code allocating in steady state.
+ *
+ * The allocations are intercepted by a replacement of the global operator new and operator delete,
+ * compiled only when SofaGLFW is built with SOFAGLFW_ENABLE_ALLOCATION_TRACKER. Otherwise the
+ * tracker is not available and the scopes do nothing.
+ */
+class SOFAGLFW_API SofaGLFWAllocationTracker
+{
+public:
+    enum class Scope
+    {
+        Step,  ///< SofaGLFWBaseGUI::runStep
+        Frame, ///< the GUI engine building and rendering its frame
+        NbScopes
+    };
+
+    struct Counters
+    {
+        std::uint64_t nbAllocations {};
+        std::uint64_t allocatedBytes {};
+        std::uint64_t nbDeallocations {};
+        std::uint64_t freedBytes {};
+        std::uint64_t peakLiveBytes {}; ///< highest amount of bytes allocated and not freed since the beginning of the scope
+    };
+
+    /// Counts the allocations from its construction to its destruction
+    class ScopedTracking
+    {
+    public:
+        explicit ScopedTracking(Scope scope) : m_scope(scope) { begin(scope); }
+        ~ScopedTracking() { end(m_scope); }
+        ScopedTracking(const ScopedTracking&) = delete;
+        ScopedTracking& operator=(const ScopedTracking&) = delete;
+    private:
+        Scope m_scope;
+    };
+
+    /// True if SofaGLFW has been built with the replacement of operator new
+    static bool isAvailable();
+
+    static void setEnabled(bool isEnabled);
+    static bool isEnabled();
+
+    static void begin(Scope scope);
+    static void end(Scope scope);
+
+    /// Counters of the last completed scope
+    static Counters getLastCounters(Scope scope);
+    /// Number of completed scopes, to know if the last counters have changed
+    static std::uint64_t getNbCompletedScopes(Scope scope);
+
+    /// Called by the replacement of operator new / operator delete
+    static void onAllocation(void* pointer) noexcept;
+    static void onDeallocation(void* pointer) noexcept;
+};
+
+} // namespace sofaglfw
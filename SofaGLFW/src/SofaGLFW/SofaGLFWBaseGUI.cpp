@@ -32,6 +32,8 @@
 #include <sofa/simulation/Simulation.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <SofaGLFW/SofaGLFWMouseManager.h>
+#include <SofaGLFW/SofaGLFWAllocationTracker.h>
+#include <SofaGLFW/SofaGLFWFrameStages.h>
 
 #include <sofa/component/visual/InteractiveCamera.h>
 #include <sofa/component/visual/VisualStyle.h>
@@ -39,6 +41,7 @@
 #include <sofa/helper/io/STBImage.h>
 
 #include <algorithm>
+#include <chrono>
 #include <sofa/helper/system/FileRepository.h>
 #include <sofa/simulation/SimulationLoop.h>
 
@@ -78,6 +81,11 @@ core::sptr<Node> SofaGLFWBaseGUI::getRootNode() const
     return m_groot;
 }
 
+void SofaGLFWBaseGUI::propagateEvent(core::objectmodel::Event* event)
+{
+    m_listenerIndex.propagateEvent(event);
+}
+
 bool SofaGLFWBaseGUI::init(int nbMSAASamples)
 {
     if (m_bGlfwIsInitialized)
@@ -111,6 +119,7 @@ void SofaGLFWBaseGUI::setSimulation(NodeSPtr groot, const std::string& filename)
 {
     m_groot = groot;
     m_filename = filename;
+    m_listenerIndex.setRoot(m_groot);
 
     VisualParams::defaultInstance()->drawTool() = m_glDrawTool;
 
@@ -180,6 +189,13 @@ int SofaGLFWBaseGUI::getHeight()
 
 void SofaGLFWBaseGUI::redraw()
 {
+    for (auto& [glfwWindow, sofaGlfwWindow] : s_mapWindows)
+    {
+        if (sofaGlfwWindow)
+        {
+            sofaGlfwWindow->invalidateSceneImage();
+        }
+    }
 }
 
 void SofaGLFWBaseGUI::drawScene()
@@ -452,9 +468,12 @@ std::size_t SofaGLFWBaseGUI::runLoop(std::size_t targetNbIterations)
     {
         SIMULATION_LOOP_SCOPE
 
+        const auto frameBegin = std::chrono::steady_clock::now();
+
         // Keep running
         runStep();
 
+        const auto drawBegin = std::chrono::steady_clock::now();
         for (auto& [glfwWindow, sofaGlfwWindow] : s_mapWindows)
         {
             if (sofaGlfwWindow)
@@ -464,14 +483,29 @@ std::size_t SofaGLFWBaseGUI::runLoop(std::size_t targetNbIterations)
                 {
                     makeCurrentContext(glfwWindow);
 
-                    m_guiEngine->beforeDraw(glfwWindow);
-                    sofaGlfwWindow->draw(m_groot, m_vparams);
-                    m_guiEngine->afterDraw();
-
-                    m_guiEngine->startFrame(this);
-                    m_guiEngine->endFrame();
-
-                    glfwSwapBuffers(glfwWindow);
+                    {
+                        SofaGLFWFrameStages::ScopedStage stage(SofaGLFWFrameStages::Stage::SceneDraw);
+                        m_guiEngine->beforeDraw(glfwWindow);
+                        // the image kept by the GUI engine is composited again if the scene did not change
+                        if (!m_guiEngine->canReuseLastSceneImage() || sofaGlfwWindow->isSceneImageOutdated(m_groot, m_vparams))
+                        {
+                            sofaGlfwWindow->draw(m_groot, m_vparams);
+                        }
+                        m_guiEngine->afterDraw();
+                    }
+
+                    {
+                        // the GUI engine measures the rendering of its frame in a nested stage
+                        SofaGLFWFrameStages::ScopedStage stage(SofaGLFWFrameStages::Stage::UIBuild);
+                        SofaGLFWAllocationTracker::ScopedTracking allocationTracking(SofaGLFWAllocationTracker::Scope::Frame);
+                        m_guiEngine->startFrame(this);
+                        m_guiEngine->endFrame();
+                    }
+
+                    {
+                        SofaGLFWFrameStages::ScopedStage stage(SofaGLFWFrameStages::Stage::Swap);
+                        glfwSwapBuffers(glfwWindow);
+                    }
 
 
                     m_viewPortHeight = m_vparams->viewport()[3];
@@ -485,13 +519,42 @@ std::size_t SofaGLFWBaseGUI::runLoop(std::size_t targetNbIterations)
                 }
             }
         }
+        const auto drawEnd = std::chrono::steady_clock::now();
 
-        glfwPollEvents();
+        {
+            SofaGLFWFrameStages::ScopedStage stage(SofaGLFWFrameStages::Stage::Poll);
+            glfwPollEvents();
+            dispatchQueuedMouseMoves();
+        }
+
+        if (m_metricsPublisher)
+        {
+            m_metricsPublisher->recordFrame(std::chrono::steady_clock::now() - frameBegin, drawEnd - drawBegin);
+        }
+
+        SofaGLFWFrameStages::endFrame();
 
         currentNbIterations++;
         running = (targetNbIterations > 0) ? currentNbIterations < targetNbIterations : true;
     }
 
+    if (m_traceWriter)
+    {
+        m_traceWriter->close();
+    }
+    if (m_profileRecorder)
+    {
+        m_profileRecorder->stop();
+        if (!m_profileRecorder->hasFailed())
+        {
+            m_profileRecorder->logSummary();
+        }
+    }
+    if (m_metricsPublisher)
+    {
+        m_metricsPublisher->stop();
+    }
+
     return currentNbIterations;
 }
 
@@ -555,14 +618,98 @@ void SofaGLFWBaseGUI::runStep()
     if(simulationIsRunning())
     {
         helper::AdvancedTimer::begin("Animate");
+        const auto stepBegin = std::chrono::steady_clock::now();
 
-        node::animate(m_groot.get(), m_groot->getDt());
-        node::updateVisual(m_groot.get());
+        {
+            SofaGLFWAllocationTracker::ScopedTracking allocationTracking(SofaGLFWAllocationTracker::Scope::Step);
+            {
+                SofaGLFWFrameStages::ScopedStage stage(SofaGLFWFrameStages::Stage::Step);
+                node::animate(m_groot.get(), m_groot->getDt());
+            }
+            {
+                SofaGLFWFrameStages::ScopedStage stage(SofaGLFWFrameStages::Stage::UpdateVisual);
+                node::updateVisual(m_groot.get());
+            }
+        }
 
+        const auto stepEnd = std::chrono::steady_clock::now();
         helper::AdvancedTimer::end("Animate");
+
+        if (m_metricsPublisher)
+        {
+            m_metricsPublisher->recordStep(stepEnd - stepBegin, m_groot->getTime());
+        }
+
+        if (m_traceWriter || m_profileRecorder)
+        {
+            const auto records = helper::AdvancedTimer::getRecords("Animate");
+            if (m_traceWriter)
+            {
+                m_traceWriter->writeStep(records);
+            }
+            if (m_profileRecorder)
+            {
+                m_profileRecorder->recordStep(records);
+            }
+        }
     }
 }
 
+bool SofaGLFWBaseGUI::setTraceFile(const std::string& filename)
+{
+    m_traceWriter = std::make_unique<SofaGLFWTraceWriter>(filename);
+    if (!m_traceWriter->isOpen())
+    {
+        m_traceWriter.reset();
+        return false;
+    }
+
+    enableStepRecords();
+    return true;
+}
+
+bool SofaGLFWBaseGUI::setProfileFile(const std::string& filename)
+{
+    m_profileRecorder = std::make_unique<SofaGLFWProfileRecorder>(filename);
+    if (!m_profileRecorder->isOpen())
+    {
+        m_profileRecorder.reset();
+        return false;
+    }
+
+    enableStepRecords();
+    return true;
+}
+
+bool SofaGLFWBaseGUI::setMetricsEndpoint(const std::string& endpoint)
+{
+    m_metricsPublisher = SofaGLFWMetricsPublisher::create(endpoint);
+    return m_metricsPublisher != nullptr;
+}
+
+bool SofaGLFWBaseGUI::setLogFile(const std::string& filename)
+{
+    // the messages are dropped rather than slowing down the threads sending them, if the disk cannot keep up
+    static constexpr std::size_t maxPendingMessages = 100000;
+    m_logFile = std::make_unique<SofaGLFWLogFile>(filename, maxPendingMessages);
+    if (!m_logFile->isOpen())
+    {
+        m_logFile.reset();
+        return false;
+    }
+
+    m_logFile->captureMessages();
+    return true;
+}
+
+void SofaGLFWBaseGUI::enableStepRecords()
+{
+    // the records of each step are kept by the timer to be collected after the step
+    helper::AdvancedTimer::setEnabled("Animate", true);
+    helper::AdvancedTimer::setInterval("Animate", 1);
+    helper::AdvancedTimer::setOutputType("Animate", "gui");
+}
+
 void SofaGLFWBaseGUI::terminate()
 {
     if (!m_bGlfwIsInitialized)
@@ -617,13 +764,16 @@ void SofaGLFWBaseGUI::key_callback(GLFWwindow* window, int key, int scancode, in
             dmsg_info_when(key == GLFW_KEY_LEFT_CONTROL, "SofaGLFWBaseGUI") << "KeyPressEvent, CONTROL pressed";
 
             KeypressedEvent keyPressedEvent(keyName);
-            rootNode->propagateEvent(core::ExecParams::defaultInstance(), &keyPressedEvent);
+            currentGUI->second->propagateEvent(&keyPressedEvent);
         }
         else if (action == GLFW_RELEASE)
         {
             KeyreleasedEvent keyReleasedEvent(keyName);
-            rootNode->propagateEvent(core::ExecParams::defaultInstance(), &keyReleasedEvent);
+            currentGUI->second->propagateEvent(&keyReleasedEvent);
         }
+
+        // components reacting to the key may have changed the scene
+        currentGUI->second->redraw();
     }
 
     // Handle specific keys for additional functionality
@@ -677,6 +827,10 @@ void SofaGLFWBaseGUI::moveRayPickInteractor(int eventX, int eventY)
     m_vparams->getProjectionMatrix(lastProjectionMatrix);
     m_vparams->getModelViewMatrix(lastModelviewMatrix);
 
+    // the event is expressed relatively to the viewport, which may not start at the origin of the framebuffer
+    eventX += viewport[0];
+    eventY -= viewport[1];
+
     Vec3d p0;
     Vec3d px;
     Vec3d py;
@@ -751,6 +905,17 @@ void SofaGLFWBaseGUI::mouse_button_callback(GLFWwindow* window, int button, int
         return;
     }
 
+    // the move queued before this event is dispatched first, so that the events keep their order: a drag
+    // whose press, moves and release are all polled in the same frame is not lost. GLFW has already
+    // updated the state of the button: the move is dispatched with its state before the event.
+    if (const auto currentSofaWindow = s_mapWindows.find(window); currentSofaWindow != s_mapWindows.end())
+    {
+        const int leftButtonState = button == GLFW_MOUSE_BUTTON_LEFT
+            ? (action == GLFW_PRESS ? GLFW_RELEASE : GLFW_PRESS)
+            : glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
+        dispatchQueuedMouseMove(window, currentSofaWindow->second, leftButtonState);
+    }
+
     const bool shiftPressed = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS;
 
     if (shiftPressed )
@@ -800,30 +965,55 @@ void SofaGLFWBaseGUI::translateToViewportCoordinates (SofaGLFWBaseGUI* gui,doubl
 void SofaGLFWBaseGUI::cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
 {
     auto currentGUI = s_mapGUIs.find(window);
-
-    if (currentGUI != s_mapGUIs.end() && currentGUI->second)
+    if (currentGUI == s_mapGUIs.end() || !currentGUI->second)
     {
-        if (!currentGUI->second->getGUIEngine()->dispatchMouseEvents())
-            return;
+        return;
     }
-    SofaGLFWBaseGUI* gui = currentGUI->second;
 
-    translateToViewportCoordinates(gui,xpos,ypos);
-
-    bool shiftPressed = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS;
-    int state = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
+    if (!currentGUI->second->getGUIEngine()->dispatchMouseEvents())
+        return;
 
+    // this callback can be called several times per frame: the moves are coalesced,
+    // and only the last position is dispatched to the scene (see dispatchQueuedMouseMoves)
     auto currentSofaWindow = s_mapWindows.find(window);
+    if (currentSofaWindow != s_mapWindows.end() && currentSofaWindow->second)
+    {
+        currentSofaWindow->second->queueMouseMove(xpos, ypos);
+    }
+}
+
+void SofaGLFWBaseGUI::dispatchQueuedMouseMoves()
+{
+    for (auto& [glfwWindow, sofaGlfwWindow] : s_mapWindows)
+    {
+        dispatchQueuedMouseMove(glfwWindow, sofaGlfwWindow, glfwGetMouseButton(glfwWindow, GLFW_MOUSE_BUTTON_LEFT));
+    }
+}
 
-    if (shiftPressed && state == GLFW_PRESS)
+void SofaGLFWBaseGUI::dispatchQueuedMouseMove(GLFWwindow* glfwWindow, SofaGLFWWindow* sofaGlfwWindow, const int leftButtonState)
+{
+    double xpos, ypos;
+    if (!sofaGlfwWindow || !sofaGlfwWindow->popQueuedMouseMove(xpos, ypos))
     {
-        currentSofaWindow->second->mouseEvent(window,gui->m_viewPortWidth,gui->m_viewPortHeight, 0, 1, 1, gui->m_translatedCursorPos[0], gui->m_translatedCursorPos[1]);
+        return;
     }
 
-    if (currentSofaWindow != s_mapWindows.end() && currentSofaWindow->second)
+    const auto currentGUI = s_mapGUIs.find(glfwWindow);
+    if (currentGUI == s_mapGUIs.end() || !currentGUI->second)
     {
-        currentSofaWindow->second->mouseMoveEvent(static_cast<int>(xpos), static_cast<int>(ypos), currentGUI->second);
+        return;
     }
+    SofaGLFWBaseGUI* gui = currentGUI->second;
+
+    translateToViewportCoordinates(gui, xpos, ypos);
+
+    const bool shiftPressed = glfwGetKey(glfwWindow, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS || glfwGetKey(glfwWindow, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS;
+    if (shiftPressed && leftButtonState == GLFW_PRESS)
+    {
+        sofaGlfwWindow->mouseEvent(glfwWindow, gui->m_viewPortWidth, gui->m_viewPortHeight, 0, 1, 1, gui->m_translatedCursorPos[0], gui->m_translatedCursorPos[1]);
+    }
+
+    sofaGlfwWindow->mouseMoveEvent(static_cast<int>(xpos), static_cast<int>(ypos), gui);
 }
 
 void SofaGLFWBaseGUI::scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
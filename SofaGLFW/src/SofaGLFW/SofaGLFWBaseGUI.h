@@ -32,6 +32,11 @@
 #include <memory>
 
 #include <SofaGLFW/SofaGLFWMouseManager.h>
+#include <SofaGLFW/SofaGLFWListenerIndex.h>
+#include <SofaGLFW/SofaGLFWTraceWriter.h>
+#include <SofaGLFW/SofaGLFWProfileRecorder.h>
+#include <SofaGLFW/SofaGLFWMetricsPublisher.h>
+#include <SofaGLFW/SofaGLFWLogFile.h>
 
 struct GLFWwindow;
 struct GLFWmonitor;
@@ -85,6 +90,8 @@ public:
     virtual void setBackgroundImage(const std::string& imageFileName = "textures/SOFA_logo.bmp", unsigned int windowID = 0);
 
     sofa::core::sptr<Node> getRootNode() const;
+    /// Sends the event to the components of the scene listening to events
+    void propagateEvent(sofa::core::objectmodel::Event* event);
     bool hasWindow() const { return m_firstWindow != nullptr; }
 
     [[nodiscard]] std::string getFilename() const { return m_filename; }
@@ -106,6 +113,17 @@ public:
     }
     void moveRayPickInteractor(int eventX, int eventY) override ;
 
+    /// Writes the AdvancedTimer records of each time step computed by runLoop in a Chrome Trace / Perfetto JSON file
+    bool setTraceFile(const std::string& filename);
+    /// Records the AdvancedTimer records of each time step computed by runLoop in a binary file, and logs a summary of the timers at the end of runLoop
+    bool setProfileFile(const std::string& filename);
+    /// True while the "Animate" AdvancedTimer must stay enabled, i.e. while a trace or profiling file is written
+    bool areStepRecordsRequired() const { return m_traceWriter || m_profileRecorder; }
+    /// Publishes live metrics of the steps and frames computed by runLoop, e.g. "prometheus://9100" or "statsd://localhost:8125"
+    bool setMetricsEndpoint(const std::string& endpoint);
+    /// Writes the messages sent from now on in a text file, until the destruction of the GUI
+    bool setLogFile(const std::string& filename);
+
 private:
     // GLFW callbacks
     static void error_callback(int error, const char* description);
@@ -124,6 +142,10 @@ private:
 
     void makeCurrentContext(GLFWwindow* sofaWindow);
     void runStep();
+    void enableStepRecords();
+    void dispatchQueuedMouseMoves();
+    /// Dispatches the move queued for a window, if any, to the scene, with the given state of the left button
+    static void dispatchQueuedMouseMove(GLFWwindow* glfwWindow, SofaGLFWWindow* sofaGlfwWindow, int leftButtonState);
 
     inline static std::map<GLFWwindow*, SofaGLFWWindow*> s_mapWindows{};
     inline static std::map<GLFWwindow*, SofaGLFWBaseGUI*> s_mapGUIs{};
@@ -143,6 +165,11 @@ private:
     int m_lastWindowWidth{ 0 };
     int m_lastWindowHeight{ 0 };
     SofaGLFWMouseManager m_sofaGLFWMouseManager;
+    SofaGLFWListenerIndex m_listenerIndex;
+    std::unique_ptr<SofaGLFWTraceWriter> m_traceWriter;
+    std::unique_ptr<SofaGLFWProfileRecorder> m_profileRecorder;
+    std::unique_ptr<SofaGLFWMetricsPublisher> m_metricsPublisher;
+    std::unique_ptr<SofaGLFWLogFile> m_logFile;
     int m_viewPortHeight{0};
     int m_viewPortWidth {0};
     Vec2d m_translatedCursorPos;
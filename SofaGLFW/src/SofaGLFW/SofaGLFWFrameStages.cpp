@@ -0,0 +1,113 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaGLFW/SofaGLFWFrameStages.h>
+
+#include <chrono>
+
+namespace sofaglfw
+{
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct OpenedStage
+    {
+        SofaGLFWFrameStages::Stage stage;
+        Clock::time_point begin;
+    };
+
+    /// The opened stages, the innermost last. Deeper nestings are ignored.
+    std::array<OpenedStage, 8> s_openedStages;
+    std::size_t s_nbOpenedStages {};
+    std::size_t s_nbIgnoredStages {};
+
+    SofaGLFWFrameStages::Frame s_currentFrame;
+    SofaGLFWFrameStages::Frame s_lastFrame;
+    Clock::time_point s_frameBegin { Clock::now() };
+    std::uint64_t s_nbCompletedFrames {};
+
+    float toMilliseconds(Clock::duration duration)
+    {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+}
+
+void SofaGLFWFrameStages::begin(const Stage stage)
+{
+    if (s_nbOpenedStages == s_openedStages.size())
+    {
+        ++s_nbIgnoredStages;
+        return;
+    }
+    s_openedStages[s_nbOpenedStages++] = { stage, Clock::now() };
+}
+
+void SofaGLFWFrameStages::end(const Stage stage)
+{
+    if (s_nbIgnoredStages > 0)
+    {
+        --s_nbIgnoredStages;
+        return;
+    }
+    if (s_nbOpenedStages == 0 || s_openedStages[s_nbOpenedStages - 1].stage != stage)
+    {
+        return;
+    }
+
+    const float duration = toMilliseconds(Clock::now() - s_openedStages[--s_nbOpenedStages].begin);
+    s_currentFrame.stages[static_cast<std::size_t>(stage)] += duration;
+    if (s_nbOpenedStages > 0)
+    {
+        // the enclosing stage only keeps its own time
+        s_currentFrame.stages[static_cast<std::size_t>(s_openedStages[s_nbOpenedStages - 1].stage)] -= duration;
+    }
+}
+
+void SofaGLFWFrameStages::endFrame()
+{
+    const auto now = Clock::now();
+    s_currentFrame.total = toMilliseconds(now - s_frameBegin);
+    s_lastFrame = s_currentFrame;
+    s_currentFrame = Frame{};
+    s_frameBegin = now;
+    ++s_nbCompletedFrames;
+}
+
+const SofaGLFWFrameStages::Frame& SofaGLFWFrameStages::getLastFrame()
+{
+    return s_lastFrame;
+}
+
+std::uint64_t SofaGLFWFrameStages::getNbCompletedFrames()
+{
+    return s_nbCompletedFrames;
+}
+
+const char* SofaGLFWFrameStages::getName(const Stage stage)
+{
+    static constexpr std::array<const char*, nbStages> names {
+        "Poll", "Step", "Update visual", "Scene draw", "UI build", "UI render", "Swap" };
+    return stage < Stage::NbStages ? names[static_cast<std::size_t>(stage)] : "";
+}
+
+} // namespace sofaglfw
@@ -0,0 +1,86 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaGLFW/config.h>
+
+#include <array>
+#include <cstdint>
+
+namespace sofaglfw
+{
+
+/**
+ * Measures the duration of the stages of each iteration of the main loop (a frame), on the main thread.
+ *
+ * The stages are opened and closed around the corresponding calls. They can be nested: the time spent in
+ * a nested stage is not counted in the enclosing one. A stage opened several times during a frame (e.g. the
+ * scene drawn in several windows) accumulates its durations.
+ */
+class SOFAGLFW_API SofaGLFWFrameStages
+{
+public:
+    enum class Stage
+    {
+        Poll,         ///< processing of the window events
+        Step,         ///< animation of the scene
+        UpdateVisual, ///< update of the visual models after the animation
+        SceneDraw,    ///< drawing of the scene
+        UIBuild,      ///< the GUI engine building its frame
+        UIRender,     ///< the GUI engine rendering its frame
+        Swap,         ///< swap of the buffers of the windows
+        NbStages
+    };
+    static constexpr std::size_t nbStages = static_cast<std::size_t>(Stage::NbStages);
+
+    struct Frame
+    {
+        std::array<float, nbStages> stages {}; ///< in milliseconds
+        float total {};                         ///< in milliseconds, including the time spent outside of the stages
+    };
+
+    /// Measures a stage from its construction to its destruction
+    class ScopedStage
+    {
+    public:
+        explicit ScopedStage(Stage stage) : m_stage(stage) { begin(stage); }
+        ~ScopedStage() { end(m_stage); }
+        ScopedStage(const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+    private:
+        Stage m_stage;
+    };
+
+    static void begin(Stage stage);
+    static void end(Stage stage);
+
+    /// Closes the current frame: it becomes the last frame, and the next stages are counted in a new frame
+    static void endFrame();
+
+    /// Durations of the last completed frame
+    static const Frame& getLastFrame();
+    /// Number of completed frames, to know if the last frame has changed
+    static std::uint64_t getNbCompletedFrames();
+
+    static const char* getName(Stage stage);
+};
+
+} // namespace sofaglfw
@@ -0,0 +1,86 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaGLFW/SofaGLFWGraphListener.h>
+
+using namespace sofa;
+
+namespace sofaglfw
+{
+
+void SofaGLFWGraphListener::attach(simulation::Node* node)
+{
+    // avoid to register the listener twice if the node has several parents
+    node->removeListener(this);
+    node->addListener(this);
+
+    for (auto* child : node->getChildren())
+    {
+        attach(static_cast<simulation::Node*>(child));
+    }
+}
+
+void SofaGLFWGraphListener::detach(simulation::Node* node)
+{
+    node->removeListener(this);
+
+    for (auto* child : node->getChildren())
+    {
+        detach(static_cast<simulation::Node*>(child));
+    }
+}
+
+void SofaGLFWGraphListener::onEndAddChild(simulation::Node* parent, simulation::Node* child)
+{
+    SOFA_UNUSED(parent);
+    attach(child);
+    isGraphModified = true;
+    onGraphModified();
+}
+
+void SofaGLFWGraphListener::onEndRemoveChild(simulation::Node* parent, simulation::Node* child)
+{
+    SOFA_UNUSED(parent);
+    if (child->getParents().empty())
+    {
+        detach(child);
+    }
+    isGraphModified = true;
+    onGraphModified();
+}
+
+void SofaGLFWGraphListener::onEndAddObject(simulation::Node* parent, core::objectmodel::BaseObject* object)
+{
+    SOFA_UNUSED(parent);
+    SOFA_UNUSED(object);
+    isGraphModified = true;
+    onGraphModified();
+}
+
+void SofaGLFWGraphListener::onEndRemoveObject(simulation::Node* parent, core::objectmodel::BaseObject* object)
+{
+    SOFA_UNUSED(parent);
+    SOFA_UNUSED(object);
+    isGraphModified = true;
+    onGraphModified();
+}
+
+} // namespace sofaglfw
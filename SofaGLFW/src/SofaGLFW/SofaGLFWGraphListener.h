@@ -0,0 +1,59 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaGLFW/config.h>
+
+#include <sofa/simulation/MutationListener.h>
+#include <sofa/simulation/Node.h>
+
+namespace sofaglfw
+{
+
+/**
+ * MutationListener registered on every node of a scene graph, to know when a node or a component is
+ * added or removed, so that the data computed from the graph are only computed again after a change.
+ *
+ * The listener follows the graph: it registers itself on the nodes added, and unregisters from the
+ * nodes removed. Its owner must detach it from the root before the graph or the listener is destroyed.
+ */
+class SOFAGLFW_API SofaGLFWGraphListener : public sofa::simulation::MutationListener
+{
+public:
+    /// Registers the listener on a node and its descendants
+    void attach(sofa::simulation::Node* node);
+    /// Unregisters the listener from a node and its descendants
+    void detach(sofa::simulation::Node* node);
+
+    void onEndAddChild(sofa::simulation::Node* parent, sofa::simulation::Node* child) override;
+    void onEndRemoveChild(sofa::simulation::Node* parent, sofa::simulation::Node* child) override;
+    void onEndAddObject(sofa::simulation::Node* parent, sofa::core::objectmodel::BaseObject* object) override;
+    void onEndRemoveObject(sofa::simulation::Node* parent, sofa::core::objectmodel::BaseObject* object) override;
+
+    /// Set at each change of the graph, reset by the owner once it has taken the changes into account
+    bool isGraphModified { true };
+
+protected:
+    /// Called at each change of the graph, after isGraphModified is set
+    virtual void onGraphModified() {}
+};
+
+} // namespace sofaglfw
@@ -0,0 +1,200 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaGLFW/SofaGLFWListenerIndex.h>
+
+#include <sofa/simulation/Node.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <set>
+
+using namespace sofa;
+
+namespace sofaglfw
+{
+
+SofaGLFWListenerIndex::~SofaGLFWListenerIndex()
+{
+    if (m_root)
+    {
+        detach(m_root.get());
+    }
+}
+
+void SofaGLFWListenerIndex::setRoot(simulation::NodeSPtr root)
+{
+    if (m_root == root)
+        return;
+
+    if (m_root)
+    {
+        detach(m_root.get());
+    }
+
+    m_root = root;
+    clear();
+
+    if (m_root)
+    {
+        attach(m_root.get());
+    }
+}
+
+void SofaGLFWListenerIndex::invalidate()
+{
+    m_isDirty = true;
+    if (!m_isDispatching)
+    {
+        // release the components as soon as possible: they may have been removed from the graph
+        clear();
+    }
+}
+
+void SofaGLFWListenerIndex::clear()
+{
+    m_nodes.clear();
+    m_listeners.clear();
+    m_silentObjects.clear();
+    m_isDirty = true;
+}
+
+bool SofaGLFWListenerIndex::hasListeningChanged() const
+{
+    return std::any_of(m_silentObjects.begin(), m_silentObjects.end(), [](const auto& silentObject)
+    {
+        return silentObject.first->f_listening.getCounter() != silentObject.second;
+    });
+}
+
+void SofaGLFWListenerIndex::rebuild()
+{
+    clear();
+    m_isDirty = false;
+
+    if (!m_root)
+        return;
+
+    std::set<const simulation::Node*> visited;
+    std::size_t order {};
+
+    std::function<void(simulation::Node*, std::size_t)> indexNode;
+    indexNode = [this, &visited, &order, &indexNode](simulation::Node* node, const std::size_t parentOrder)
+    {
+        // a node with several parents is visited only once, from its first parent
+        if (!visited.insert(node).second)
+            return;
+
+        // the entry is kept if there are listening components in the subtree: when the node is
+        // deactivated, its whole subtree is skipped
+        const std::size_t index = m_nodes.size();
+
+        NodeEntry entry;
+        entry.node = node;
+        entry.order = ++order;
+        entry.parentOrder = parentOrder;
+        entry.begin = m_listeners.size();
+        for (const auto& object : node->object)
+        {
+            if (object->f_listening.getValue())
+            {
+                m_listeners.push_back(object);
+            }
+            else
+            {
+                m_silentObjects.emplace_back(object.get(), object->f_listening.getCounter());
+            }
+        }
+        entry.end = m_listeners.size();
+        m_nodes.push_back(entry);
+
+        for (auto* child : node->getChildren())
+        {
+            indexNode(static_cast<simulation::Node*>(child), entry.order);
+        }
+
+        if (m_nodes.size() == index + 1 && entry.begin == entry.end)
+        {
+            m_nodes.pop_back();
+        }
+        else
+        {
+            m_nodes[index].subtreeEnd = m_nodes.size();
+        }
+    };
+
+    indexNode(m_root.get(), 0);
+}
+
+void SofaGLFWListenerIndex::propagateEvent(core::objectmodel::Event* event)
+{
+    if (!m_root || !event)
+        return;
+
+    if (m_isDirty || hasListeningChanged())
+    {
+        rebuild();
+    }
+
+    m_isDispatching = true;
+
+    // Node::propagateEvent prunes the children of a node if the event is handled once its objects are processed.
+    // The objects of a node are then reached if the event was not handled when its parent was processed.
+    std::size_t handledOrder = event->isHandled() ? 1 : std::numeric_limits<std::size_t>::max();
+
+    for (std::size_t n = 0; n < m_nodes.size();)
+    {
+        const auto& entry = m_nodes[n];
+        if (!entry.node->isActive())
+        {
+            // as Node::propagateEvent, the subtree of an inactive node is not visited
+            n = entry.subtreeEnd;
+            continue;
+        }
+        ++n;
+        if (entry.parentOrder >= handledOrder)
+            continue;
+
+        for (std::size_t i = entry.begin; i < entry.end; ++i)
+        {
+            auto& listener = m_listeners[i];
+            if (listener->f_listening.getValue())
+            {
+                listener->handleEvent(event);
+            }
+        }
+
+        if (event->isHandled() && handledOrder > entry.order)
+        {
+            handledOrder = entry.order;
+        }
+    }
+
+    m_isDispatching = false;
+
+    if (m_isDirty)
+    {
+        clear();
+    }
+}
+
+} // namespace sofaglfw
@@ -0,0 +1,93 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaGLFW/config.h>
+
+#include <SofaGLFW/SofaGLFWGraphListener.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/core/objectmodel/Event.h>
+
+#include <utility>
+#include <vector>
+
+namespace sofaglfw
+{
+
+/**
+ * Index of the components listening to events (f_listening enabled) in a scene graph.
+ *
+ * Propagating an event with Node::propagateEvent visits every node and every object of the graph,
+ * even if only a few of them listen to events. The index keeps the listening components in the order
+ * of a top-down traversal, so that an event is only dispatched to them.
+ * The index listens to the changes of the graph (SofaGLFWGraphListener), and is rebuilt lazily after
+ * a component or a node has been added or removed.
+ *
+ * A component which stops listening is skipped. The components which do not listen are kept with the
+ * counter of their f_listening data: the index is rebuilt before an event if one of them has changed,
+ * e.g. when listening is enabled from the component inspector. Comparing the counters is much cheaper
+ * than the visit of the whole graph by Node::propagateEvent.
+ */
+class SOFAGLFW_API SofaGLFWListenerIndex : public SofaGLFWGraphListener
+{
+public:
+    SofaGLFWListenerIndex() = default;
+    ~SofaGLFWListenerIndex() override;
+
+    void setRoot(sofa::simulation::NodeSPtr root);
+
+    /// Forces the index to be rebuilt before the next propagation
+    void invalidate();
+
+    /// Sends the event to the listening components, with the same pruning rules as Node::propagateEvent
+    void propagateEvent(sofa::core::objectmodel::Event* event);
+
+protected:
+    void onGraphModified() override { invalidate(); }
+
+private:
+    /// Listening components of a node. There is an entry for each node having listening components in its subtree.
+    struct NodeEntry
+    {
+        sofa::simulation::Node* node { nullptr };
+        std::size_t order {}; ///< rank of the node in the top-down traversal, starting at 1
+        std::size_t parentOrder {}; ///< rank of the parent node, 0 for the root
+        std::size_t begin {}; ///< first component of the node in m_listeners
+        std::size_t end {};
+        std::size_t subtreeEnd {}; ///< index in m_nodes following the entries of the subtree of the node
+    };
+
+    void rebuild();
+    void clear();
+    /// True if a component not listening when the index was built may have started to
+    bool hasListeningChanged() const;
+
+    sofa::simulation::NodeSPtr m_root;
+    std::vector<NodeEntry> m_nodes;
+    std::vector<sofa::core::objectmodel::BaseObject::SPtr> m_listeners;
+    /// the components not listening, and the counter of their f_listening data. They are removed from
+    /// the index as soon as they leave the graph.
+    std::vector<std::pair<const sofa::core::objectmodel::BaseObject*, int>> m_silentObjects;
+    bool m_isDirty { true };
+    bool m_isDispatching { false };
+};
+
+} // namespace sofaglfw
@@ -0,0 +1,218 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaGLFW/SofaGLFWLogFile.h>
+
+#include <sofa/core/objectmodel/Base.h>
+#include <sofa/helper/logging/MessageDispatcher.h>
+#include <sofa/helper/logging/Messaging.h>
+
+#include <array>
+
+namespace sofaglfw
+{
+
+SofaGLFWLogFile::SofaGLFWLogFile(const std::string& filename, const std::size_t maxPendingLines)
+    : m_filename(filename)
+    , m_maxPendingLines(maxPendingLines)
+    , m_buffer(1 << 20)
+{
+    // the lines are written in large blocks: the file is flushed when there is nothing left to write
+    m_file.rdbuf()->pubsetbuf(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_file.open(filename, std::ios::out | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        msg_error("SofaGLFWLogFile") << "Cannot open the file " << filename;
+        m_isFinished = true;
+        return;
+    }
+
+    m_isOpen = true;
+    m_thread = std::thread(&SofaGLFWLogFile::writeLoop, this);
+}
+
+SofaGLFWLogFile::~SofaGLFWLogFile()
+{
+    if (m_isCapturing)
+    {
+        sofa::helper::logging::MessageDispatcher::rmHandler(&m_sink);
+    }
+    finish();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+bool SofaGLFWLogFile::write(std::string line)
+{
+    if (!m_isOpen || m_hasFailed)
+    {
+        return false;
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_isFinishing)
+        {
+            return false;
+        }
+        if (m_maxPendingLines > 0 && m_pendingLines.size() >= m_maxPendingLines)
+        {
+            ++m_nbDroppedLines;
+            return false;
+        }
+        m_pendingLines.push_back(std::move(line));
+    }
+    m_condition.notify_one();
+    return true;
+}
+
+void SofaGLFWLogFile::captureMessages()
+{
+    if (m_isOpen && !m_isCapturing)
+    {
+        sofa::helper::logging::MessageDispatcher::addHandler(&m_sink);
+        m_isCapturing = true;
+    }
+}
+
+void SofaGLFWLogFile::finish()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_isFinishing = true;
+    }
+    m_condition.notify_one();
+}
+
+std::size_t SofaGLFWLogFile::getNbPendingLines() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_pendingLines.size();
+}
+
+std::string SofaGLFWLogFile::format(const sofa::helper::logging::Message& message)
+{
+    std::string componentName;
+    std::string componentPath;
+    if (const auto* nfo = dynamic_cast<sofa::helper::logging::SofaComponentInfo*>(message.componentInfo().get()))
+    {
+        componentName = nfo->name();
+        if (nfo->m_component)
+        {
+            componentPath = nfo->m_component->getPathName();
+        }
+    }
+    return format(message.type(), componentName, componentPath, message.messageAsString());
+}
+
+std::string SofaGLFWLogFile::format(const sofa::helper::logging::Message::Type type, const std::string& componentName,
+                                    const std::string& componentPath, const std::string& text)
+{
+    using sofa::helper::logging::Message;
+    static constexpr std::array<const char*, static_cast<std::size_t>(Message::TypeCount)> labels {
+        "INFO", "SUGGESTION", "DEPRECATED", "WARNING", "ERROR", "FATAL", "EMPTY" };
+
+    const auto typeIndex = static_cast<std::size_t>(type);
+    std::string line = "[";
+    line += typeIndex < labels.size() ? labels[typeIndex] : "";
+    line += "]";
+    if (!componentName.empty())
+    {
+        line += " " + componentName;
+    }
+    if (!componentPath.empty())
+    {
+        line += " (" + componentPath + ")";
+    }
+    line += " " + text;
+    return line;
+}
+
+void SofaGLFWLogFile::Sink::process(sofa::helper::logging::Message& m)
+{
+    m_file.write(format(m));
+}
+
+void SofaGLFWLogFile::writeLoop()
+{
+    std::vector<std::string> lines;
+    while (true)
+    {
+        std::size_t nbDroppedLines = 0;
+        bool isFinishing = false;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_isFinishing || !m_pendingLines.empty(); });
+            lines.swap(m_pendingLines);
+            std::swap(nbDroppedLines, m_nbDroppedLines);
+            isFinishing = m_isFinishing;
+        }
+
+        if (!m_hasFailed)
+        {
+            for (const auto& line : lines)
+            {
+                m_file << line << '\n';
+            }
+            if (nbDroppedLines > 0)
+            {
+                m_file << "[" << nbDroppedLines << " messages dropped: they were sent faster than they could be written]\n";
+            }
+            if (m_file)
+            {
+                m_nbWrittenLines += lines.size();
+            }
+            else
+            {
+                // set before logging, so that a sink does not queue the error itself
+                m_hasFailed = true;
+                msg_error("SofaGLFWLogFile") << "Cannot write the file " << m_filename << ", the next lines are not written";
+            }
+        }
+        lines.clear();
+
+        bool isIdle = false;
+        {
+            std::lock_guard lock(m_mutex);
+            isIdle = m_pendingLines.empty();
+        }
+        if (isIdle)
+        {
+            if (isFinishing)
+            {
+                break;
+            }
+            // the file is up to date whenever nothing is left to write
+            m_file.flush();
+        }
+    }
+
+    m_file.close();
+    if (!m_hasFailed && m_file.fail())
+    {
+        m_hasFailed = true;
+        msg_error("SofaGLFWLogFile") << "Cannot write the file " << m_filename;
+    }
+    m_isFinished = true;
+}
+
+} // namespace sofaglfw
@@ -0,0 +1,118 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaGLFW/config.h>
+
+#include <sofa/helper/logging/Message.h>
+#include <sofa/helper/logging/MessageHandler.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sofaglfw
+{
+
+/**
+ * Text file of log messages, written by a background thread with buffered output, so that the threads
+ * handing the lines never wait for the file.
+ *
+ * It is used to export a log, and as a continuous sink of the messages sent to the message dispatcher.
+ * A sink keeps a bounded number of lines waiting to be written: if the messages are sent faster than
+ * they can be written, the extra ones are dropped, and their number is written in the file.
+ */
+class SOFAGLFW_API SofaGLFWLogFile
+{
+public:
+    /// @param maxPendingLines Number of lines waiting to be written beyond which the next lines are dropped, 0 for no limit
+    explicit SofaGLFWLogFile(const std::string& filename, std::size_t maxPendingLines = 0);
+    /// Writes the pending lines and closes the file
+    ~SofaGLFWLogFile();
+
+    SofaGLFWLogFile(const SofaGLFWLogFile&) = delete;
+    SofaGLFWLogFile& operator=(const SofaGLFWLogFile&) = delete;
+
+    bool isOpen() const { return m_isOpen; }
+    const std::string& getFilename() const { return m_filename; }
+
+    /// Queues a line, without its end of line. Returns false if the line is dropped.
+    bool write(std::string line);
+
+    /// Writes the messages sent to the message dispatcher from now on, until the destruction
+    void captureMessages();
+
+    /// No more lines will be written: the file is closed once the pending lines are written
+    void finish();
+    /// True once the file is closed after finish()
+    bool isFinished() const { return m_isFinished; }
+    /// True if the file could not be written: the lines after the error are dropped
+    bool hasFailed() const { return m_hasFailed; }
+
+    std::size_t getNbWrittenLines() const { return m_nbWrittenLines; }
+    std::size_t getNbPendingLines() const;
+
+    /// Formats a message as a line of the file: [TYPE] component (path) message
+    static std::string format(const sofa::helper::logging::Message& message);
+    /// Same line, from the parts of a message kept after the message itself
+    static std::string format(sofa::helper::logging::Message::Type type, const std::string& componentName,
+                              const std::string& componentPath, const std::string& text);
+
+private:
+    class Sink : public sofa::helper::logging::MessageHandler
+    {
+    public:
+        explicit Sink(SofaGLFWLogFile& file) : m_file(file) {}
+        void process(sofa::helper::logging::Message& m) override;
+    private:
+        SofaGLFWLogFile& m_file;
+    };
+
+    void writeLoop();
+
+    std::string m_filename;
+    bool m_isOpen { false };
+    std::size_t m_maxPendingLines;
+    Sink m_sink { *this };
+    bool m_isCapturing { false };
+
+    // shared with the writing thread, protected by m_mutex
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<std::string> m_pendingLines;
+    std::size_t m_nbDroppedLines {};
+    bool m_isFinishing { false };
+
+    std::atomic<std::size_t> m_nbWrittenLines {};
+    std::atomic<bool> m_isFinished { false };
+    std::atomic<bool> m_hasFailed { false };
+
+    // writing thread
+    std::ofstream m_file;
+    std::vector<char> m_buffer;
+    std::thread m_thread;
+};
+
+} // namespace sofaglfw
@@ -0,0 +1,596 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaGLFW/SofaGLFWMetricsPublisher.h>
+
+#include <sofa/helper/logging/Messaging.h>
+#include <sofa/helper/logging/MessageDispatcher.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <netdb.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+namespace sofaglfw
+{
+
+namespace
+{
+
+#if defined(_WIN32)
+using SocketHandle = SOCKET;
+constexpr int sendFlags = 0;
+#elif defined(__linux__)
+using SocketHandle = int;
+constexpr int sendFlags = MSG_NOSIGNAL; // a scraper closing the connection must not kill the process
+#else
+using SocketHandle = int;
+constexpr int sendFlags = 0;
+#endif
+
+constexpr std::intptr_t invalidSocket = -1;
+
+SocketHandle toHandle(std::intptr_t socket)
+{
+    return static_cast<SocketHandle>(socket);
+}
+
+void closeSocket(std::intptr_t socket)
+{
+    if (socket == invalidSocket)
+    {
+        return;
+    }
+#if defined(_WIN32)
+    closesocket(toHandle(socket));
+#else
+    close(toHandle(socket));
+#endif
+}
+
+/// Waits until the socket can be read without blocking, or until the timeout expires
+bool waitReadable(std::intptr_t socket, int timeoutMilliseconds)
+{
+    fd_set set;
+    FD_ZERO(&set);
+    FD_SET(toHandle(socket), &set);
+    timeval timeout { timeoutMilliseconds / 1000, (timeoutMilliseconds % 1000) * 1000 };
+    return select(static_cast<int>(toHandle(socket)) + 1, &set, nullptr, nullptr, &timeout) > 0;
+}
+
+bool sendAll(std::intptr_t socket, const std::string& data)
+{
+    std::size_t sent = 0;
+    while (sent < data.size())
+    {
+        const auto n = send(toHandle(socket), data.data() + sent, static_cast<int>(data.size() - sent), sendFlags);
+        if (n <= 0)
+        {
+            return false;
+        }
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+std::uint64_t getResidentMemory()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+    {
+        return info.resident_size;
+    }
+    return 0;
+#else
+    std::ifstream statm("/proc/self/statm");
+    std::uint64_t size {}, resident {};
+    if (statm >> size >> resident)
+    {
+        return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+    return 0;
+#endif
+}
+
+/// Names of the message types, indexed by sofa::helper::logging::Message::Type
+constexpr std::array<const char*, 6> messageTypeNames { "info", "advice", "deprecated", "warning", "error", "fatal" };
+
+double toSeconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+} // namespace
+
+void SofaGLFWMetricsPublisher::MessageCounter::process(sofa::helper::logging::Message& m)
+{
+    const auto type = static_cast<std::size_t>(m.type());
+    if (type < nbMessages.size())
+    {
+        nbMessages[type].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SofaGLFWMetricsPublisher::RecentDurations::push(double value)
+{
+    values[next] = value;
+    next = (next + 1) % values.size();
+    size = std::min(size + 1, values.size());
+}
+
+SofaGLFWMetricsPublisher::Quantiles SofaGLFWMetricsPublisher::RecentDurations::computeQuantiles() const
+{
+    if (size == 0)
+    {
+        // no observation: Prometheus expects NaN
+        constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+        return { nan, nan, nan, nan };
+    }
+
+    std::vector<double> sorted(values.begin(), values.begin() + size);
+    std::sort(sorted.begin(), sorted.end());
+    const auto quantile = [&sorted](double q)
+    {
+        return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(q * sorted.size()))];
+    };
+    return { quantile(0.5), quantile(0.9), quantile(0.99), sorted.back() };
+}
+
+std::unique_ptr<SofaGLFWMetricsPublisher> SofaGLFWMetricsPublisher::create(const std::string& endpoint)
+{
+    const auto schemeEnd = endpoint.find("://");
+    const std::string scheme = schemeEnd == std::string::npos ? std::string() : endpoint.substr(0, schemeEnd);
+    Protocol protocol;
+    if (scheme == "prometheus")
+    {
+        protocol = Protocol::Prometheus;
+    }
+    else if (scheme == "statsd")
+    {
+        protocol = Protocol::Statsd;
+    }
+    else
+    {
+        msg_error("SofaGLFWMetricsPublisher") << "Invalid metrics endpoint '" << endpoint
+            << "': expected prometheus://[host:]port or statsd://host:port";
+        return nullptr;
+    }
+
+    // [host]:port, host:port or port
+    std::string address = endpoint.substr(schemeEnd + 3);
+    std::string host = "127.0.0.1";
+    std::string port = address;
+    const auto portSeparator = address.rfind(':');
+    if (portSeparator != std::string::npos)
+    {
+        host = address.substr(0, portSeparator);
+        port = address.substr(portSeparator + 1);
+        if (host.size() > 2 && host.front() == '[' && host.back() == ']')
+        {
+            host = host.substr(1, host.size() - 2);
+        }
+    }
+
+    unsigned long portNumber = 0;
+    try
+    {
+        std::size_t parsed = 0;
+        portNumber = std::stoul(port, &parsed);
+        if (parsed != port.size())
+        {
+            portNumber = 0;
+        }
+    }
+    catch (const std::exception&)
+    {
+        portNumber = 0;
+    }
+    if (portNumber == 0 || portNumber > std::numeric_limits<std::uint16_t>::max() || host.empty())
+    {
+        msg_error("SofaGLFWMetricsPublisher") << "Invalid metrics endpoint '" << endpoint << "': invalid host or port";
+        return nullptr;
+    }
+
+    auto publisher = std::make_unique<SofaGLFWMetricsPublisher>(protocol, host, static_cast<std::uint16_t>(portNumber));
+    if (!publisher->isRunning())
+    {
+        return nullptr;
+    }
+    return publisher;
+}
+
+SofaGLFWMetricsPublisher::SofaGLFWMetricsPublisher(Protocol protocol, const std::string& host, std::uint16_t port)
+    : m_protocol(protocol)
+{
+    std::ostringstream endpoint;
+    endpoint << (protocol == Protocol::Prometheus ? "http://" : "statsd://")
+             << (host.find(':') != std::string::npos ? "[" + host + "]" : host) << ":" << port
+             << (protocol == Protocol::Prometheus ? "/metrics" : "");
+    m_endpoint = endpoint.str();
+
+#if defined(_WIN32)
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+    if (!openSocket(host, port))
+    {
+        msg_error("SofaGLFWMetricsPublisher") << "Cannot publish the metrics at " << m_endpoint;
+        return;
+    }
+
+    sofa::helper::logging::MessageDispatcher::addHandler(&m_messageCounter);
+
+    m_isRunning = true;
+    if (m_protocol == Protocol::Prometheus)
+    {
+        m_thread = std::thread(&SofaGLFWMetricsPublisher::serveLoop, this);
+    }
+    else
+    {
+        m_thread = std::thread(&SofaGLFWMetricsPublisher::sendLoop, this);
+    }
+
+    msg_info("SofaGLFWMetricsPublisher") << "Publishing the metrics at " << m_endpoint;
+}
+
+SofaGLFWMetricsPublisher::~SofaGLFWMetricsPublisher()
+{
+    stop();
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+bool SofaGLFWMetricsPublisher::openSocket(const std::string& host, std::uint16_t port)
+{
+    addrinfo hints {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = m_protocol == Protocol::Prometheus ? SOCK_STREAM : SOCK_DGRAM;
+    hints.ai_flags = m_protocol == Protocol::Prometheus ? AI_PASSIVE : 0;
+
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+    {
+        return false;
+    }
+
+    for (const addrinfo* address = addresses; address != nullptr; address = address->ai_next)
+    {
+        const auto handle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+#if defined(_WIN32)
+        if (handle == INVALID_SOCKET)
+#else
+        if (handle < 0)
+#endif
+        {
+            continue;
+        }
+        const auto candidate = static_cast<std::intptr_t>(handle);
+
+        bool isOpen = false;
+        if (m_protocol == Protocol::Prometheus)
+        {
+            // the port can be reused right after a previous run
+            const int reuse = 1;
+            setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+            isOpen = bind(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0 && listen(handle, 8) == 0;
+        }
+        else
+        {
+            // a datagram socket only remembers the destination
+            isOpen = connect(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0;
+        }
+
+        if (isOpen)
+        {
+            m_socket = candidate;
+            break;
+        }
+        closeSocket(candidate);
+    }
+
+    freeaddrinfo(addresses);
+    return m_socket != invalidSocket;
+}
+
+void SofaGLFWMetricsPublisher::recordStep(std::chrono::steady_clock::duration stepDuration, double simulatedTime)
+{
+    const double duration = toSeconds(stepDuration);
+    std::lock_guard lock(m_mutex);
+    ++m_nbSteps;
+    m_stepDurationSum += duration;
+    m_stepDurations.push(duration);
+    m_simulatedTime = simulatedTime;
+}
+
+void SofaGLFWMetricsPublisher::recordFrame(std::chrono::steady_clock::duration frameDuration, std::chrono::steady_clock::duration drawDuration)
+{
+    const double draw = toSeconds(drawDuration);
+    std::lock_guard lock(m_mutex);
+    ++m_nbFrames;
+    m_drawDurationSum += draw;
+    m_drawDurations.push(draw);
+    m_frameDurations.push(toSeconds(frameDuration));
+}
+
+SofaGLFWMetricsPublisher::Snapshot SofaGLFWMetricsPublisher::takeSnapshot()
+{
+    Snapshot snapshot;
+    RecentDurations stepDurations, drawDurations, frameDurations;
+    {
+        // the quantiles are computed outside of the lock, not to slow down the main loop
+        std::lock_guard lock(m_mutex);
+        snapshot.nbSteps = m_nbSteps;
+        snapshot.nbFrames = m_nbFrames;
+        snapshot.stepDurationSum = m_stepDurationSum;
+        snapshot.drawDurationSum = m_drawDurationSum;
+        snapshot.simulatedTime = m_simulatedTime;
+        stepDurations = m_stepDurations;
+        drawDurations = m_drawDurations;
+        frameDurations = m_frameDurations;
+    }
+
+    snapshot.stepDuration = stepDurations.computeQuantiles();
+    snapshot.drawDuration = drawDurations.computeQuantiles();
+
+    // frame rate over the last second of frames
+    double elapsed = 0.;
+    std::size_t nbFrames = 0;
+    while (nbFrames < frameDurations.size && elapsed < 1.)
+    {
+        const auto index = (frameDurations.next + nbRecentDurations - 1 - nbFrames) % nbRecentDurations;
+        elapsed += frameDurations.values[index];
+        ++nbFrames;
+    }
+    snapshot.framesPerSecond = elapsed > 0. ? static_cast<double>(nbFrames) / elapsed : 0.;
+
+    snapshot.residentMemory = getResidentMemory();
+    for (std::size_t i = 0; i < nbMessageTypes; ++i)
+    {
+        snapshot.nbMessages[i] = m_messageCounter.nbMessages[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+std::string SofaGLFWMetricsPublisher::formatPrometheus(const Snapshot& snapshot) const
+{
+    std::ostringstream out;
+    out.imbue(std::locale::classic());
+    out.precision(9);
+
+    const auto header = [&out](const char* name, const char* type, const char* help)
+    {
+        out << "# HELP " << name << ' ' << help << '\n' << "# TYPE " << name << ' ' << type << '\n';
+    };
+    const auto summary = [&out, &header](const char* name, const char* help, const Quantiles& quantiles, double sum, std::uint64_t count)
+    {
+        header(name, "summary", help);
+        out << name << "{quantile=\"0.5\"} " << quantiles.p50 << '\n'
+            << name << "{quantile=\"0.9\"} " << quantiles.p90 << '\n'
+            << name << "{quantile=\"0.99\"} " << quantiles.p99 << '\n'
+            << name << "_sum " << sum << '\n'
+            << name << "_count " << count << '\n';
+    };
+
+    summary("sofa_step_duration_seconds", "Duration of the time steps (quantiles over the recent steps).",
+            snapshot.stepDuration, snapshot.stepDurationSum, snapshot.nbSteps);
+    header("sofa_step_duration_max_seconds", "gauge", "Longest of the recent time steps.");
+    out << "sofa_step_duration_max_seconds " << snapshot.stepDuration.max << '\n';
+
+    summary("sofa_draw_duration_seconds", "Duration of the drawing of the windows (quantiles over the recent frames).",
+            snapshot.drawDuration, snapshot.drawDurationSum, snapshot.nbFrames);
+
+    header("sofa_frames_per_second", "gauge", "Number of iterations of the main loop during the last second.");
+    out << "sofa_frames_per_second " << snapshot.framesPerSecond << '\n';
+
+    header("sofa_simulated_time_seconds", "gauge", "Time of the simulation.");
+    out << "sofa_simulated_time_seconds " << snapshot.simulatedTime << '\n';
+
+    header("sofa_resident_memory_bytes", "gauge", "Resident memory of the process.");
+    out << "sofa_resident_memory_bytes " << snapshot.residentMemory << '\n';
+
+    header("sofa_messages_total", "counter", "Number of messages logged, per type.");
+    for (std::size_t i = 0; i < messageTypeNames.size(); ++i)
+    {
+        out << "sofa_messages_total{type=\"" << messageTypeNames[i] << "\"} " << snapshot.nbMessages[i] << '\n';
+    }
+
+    return out.str();
+}
+
+std::vector<std::string> SofaGLFWMetricsPublisher::formatStatsd(const Snapshot& snapshot, const Snapshot& previous) const
+{
+    // several metrics per datagram, small enough not to be fragmented
+    static constexpr std::size_t maxPacketSize = 1400;
+    std::vector<std::string> packets(1);
+
+    const auto add = [&packets](const std::string& metric, double value, const char* type)
+    {
+        if (std::isnan(value))
+        {
+            return;
+        }
+        std::ostringstream line;
+        line.imbue(std::locale::classic());
+        line.precision(15);
+        line << "sofa." << metric << ':' << value << '|' << type;
+        if (!packets.back().empty() && packets.back().size() + 1 + line.str().size() > maxPacketSize)
+        {
+            packets.emplace_back();
+        }
+        if (!packets.back().empty())
+        {
+            packets.back() += '\n';
+        }
+        packets.back() += line.str();
+    };
+
+    // counters are sent as the increments since the previous flush, durations in milliseconds
+    add("steps", static_cast<double>(snapshot.nbSteps - previous.nbSteps), "c");
+    add("frames", static_cast<double>(snapshot.nbFrames - previous.nbFrames), "c");
+    add("frames_per_second", snapshot.framesPerSecond, "g");
+    add("step_duration.p50", snapshot.stepDuration.p50 * 1e3, "g");
+    add("step_duration.p90", snapshot.stepDuration.p90 * 1e3, "g");
+    add("step_duration.p99", snapshot.stepDuration.p99 * 1e3, "g");
+    add("step_duration.max", snapshot.stepDuration.max * 1e3, "g");
+    add("draw_duration.p50", snapshot.drawDuration.p50 * 1e3, "g");
+    add("draw_duration.p90", snapshot.drawDuration.p90 * 1e3, "g");
+    add("draw_duration.p99", snapshot.drawDuration.p99 * 1e3, "g");
+    add("simulated_time", snapshot.simulatedTime, "g");
+    add("resident_memory", static_cast<double>(snapshot.residentMemory), "g");
+    for (std::size_t i = 0; i < messageTypeNames.size(); ++i)
+    {
+        add(std::string("messages.") + messageTypeNames[i], static_cast<double>(snapshot.nbMessages[i] - previous.nbMessages[i]), "c");
+    }
+
+    return packets;
+}
+
+void SofaGLFWMetricsPublisher::serveLoop()
+{
+    while (m_isRunning)
+    {
+        // the timeout lets the loop notice the stop request
+        if (!waitReadable(m_socket, 200))
+        {
+            continue;
+        }
+
+        const auto handle = accept(toHandle(m_socket), nullptr, nullptr);
+#if defined(_WIN32)
+        if (handle == INVALID_SOCKET)
+#else
+        if (handle < 0)
+#endif
+        {
+            continue;
+        }
+        const auto client = static_cast<std::intptr_t>(handle);
+#if defined(__APPLE__)
+        const int noSigPipe = 1;
+        setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+        // only the request line matters, the headers are read to be discarded
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192 && waitReadable(client, 2000))
+        {
+            const auto n = recv(handle, buffer, sizeof(buffer), 0);
+            if (n <= 0)
+            {
+                break;
+            }
+            request.append(buffer, static_cast<std::size_t>(n));
+        }
+
+        std::string status = "200 OK";
+        std::string body;
+        if (request.rfind("GET /metrics ", 0) == 0 || request.rfind("GET / ", 0) == 0)
+        {
+            body = formatPrometheus(takeSnapshot());
+        }
+        else
+        {
+            status = "404 Not Found";
+            body = "The metrics are served at /metrics\n";
+        }
+
+        std::ostringstream response;
+        response << "HTTP/1.1 " << status << "\r\n"
+                 << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                 << "Content-Length: " << body.size() << "\r\n"
+                 << "Connection: close\r\n\r\n"
+                 << body;
+        sendAll(client, response.str());
+        closeSocket(client);
+    }
+}
+
+void SofaGLFWMetricsPublisher::sendLoop()
+{
+    static constexpr auto flushPeriod = std::chrono::seconds(1);
+
+    Snapshot previous = takeSnapshot();
+    auto nextFlush = std::chrono::steady_clock::now() + flushPeriod;
+    while (m_isRunning)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() < nextFlush)
+        {
+            continue;
+        }
+        nextFlush += flushPeriod;
+
+        const Snapshot snapshot = takeSnapshot();
+        for (const auto& packet : formatStatsd(snapshot, previous))
+        {
+            // nobody may listen: the errors of a datagram socket are ignored
+            send(toHandle(m_socket), packet.data(), static_cast<int>(packet.size()), sendFlags);
+        }
+        previous = snapshot;
+    }
+}
+
+void SofaGLFWMetricsPublisher::stop()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    m_isRunning = false;
+    m_thread.join();
+
+    closeSocket(m_socket);
+    m_socket = invalidSocket;
+    sofa::helper::logging::MessageDispatcher::rmHandler(&m_messageCounter);
+}
+
+} // namespace sofaglfw
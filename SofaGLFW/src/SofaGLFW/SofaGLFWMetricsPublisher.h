@@ -0,0 +1,152 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaGLFW/config.h>
+
+#include <sofa/helper/logging/MessageHandler.h>
+#include <sofa/helper/logging/Message.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sofaglfw
+{
+
+/**
+ * Publishes live metrics of a run (frame rate, step and draw durations, resident memory, number of messages,
+ * simulated time) to a monitoring system, from a background thread:
+ * - "prometheus://[host:]port": serves the metrics in the Prometheus text format over HTTP. The host defaults
+ *   to 127.0.0.1, i.e. the endpoint is only reachable from the local machine.
+ * - "statsd://host:port": sends the metrics every second to a statsd daemon over UDP.
+ *
+ * The main loop reports its steps and frames, which only updates a few values under a mutex.
+ */
+class SOFAGLFW_API SofaGLFWMetricsPublisher
+{
+public:
+    enum class Protocol : std::uint8_t
+    {
+        Prometheus,
+        Statsd
+    };
+
+    /// Parses the endpoint and starts the publication. Returns nullptr if the endpoint is invalid or unreachable.
+    static std::unique_ptr<SofaGLFWMetricsPublisher> create(const std::string& endpoint);
+
+    SofaGLFWMetricsPublisher(Protocol protocol, const std::string& host, std::uint16_t port);
+    ~SofaGLFWMetricsPublisher();
+
+    SofaGLFWMetricsPublisher(const SofaGLFWMetricsPublisher&) = delete;
+    SofaGLFWMetricsPublisher& operator=(const SofaGLFWMetricsPublisher&) = delete;
+
+    bool isRunning() const { return m_isRunning; }
+
+    /// Called after each time step computed by the main loop
+    void recordStep(std::chrono::steady_clock::duration stepDuration, double simulatedTime);
+    /// Called at the end of each iteration of the main loop. The draw duration covers the drawing of all the windows.
+    void recordFrame(std::chrono::steady_clock::duration frameDuration, std::chrono::steady_clock::duration drawDuration);
+
+    /// Stops the background thread and closes the sockets
+    void stop();
+
+private:
+    static constexpr std::size_t nbRecentDurations = 1024;
+    static constexpr std::size_t nbMessageTypes = static_cast<std::size_t>(sofa::helper::logging::Message::TypeCount);
+
+    struct Quantiles
+    {
+        double p50 {};
+        double p90 {};
+        double p99 {};
+        double max {};
+    };
+
+    /// Values read by the background thread, durations in seconds
+    struct Snapshot
+    {
+        std::uint64_t nbSteps {};
+        std::uint64_t nbFrames {};
+        double stepDurationSum {};
+        double drawDurationSum {};
+        Quantiles stepDuration;
+        Quantiles drawDuration;
+        double framesPerSecond {};
+        double simulatedTime {};
+        std::uint64_t residentMemory {}; ///< in bytes
+        std::array<std::uint64_t, nbMessageTypes> nbMessages {};
+    };
+
+    /// Counts the messages of each type, from any thread
+    class MessageCounter : public sofa::helper::logging::MessageHandler
+    {
+    public:
+        void process(sofa::helper::logging::Message& m) override;
+        std::array<std::atomic<std::uint64_t>, nbMessageTypes> nbMessages {};
+    };
+
+    /// Ring of the most recent durations, in seconds
+    struct RecentDurations
+    {
+        std::array<double, nbRecentDurations> values {};
+        std::size_t size {};
+        std::size_t next {};
+
+        void push(double value);
+        Quantiles computeQuantiles() const;
+    };
+
+    Snapshot takeSnapshot();
+    std::string formatPrometheus(const Snapshot& snapshot) const;
+    std::vector<std::string> formatStatsd(const Snapshot& snapshot, const Snapshot& previous) const;
+
+    bool openSocket(const std::string& host, std::uint16_t port);
+    void serveLoop();
+    void sendLoop();
+
+    Protocol m_protocol;
+    std::string m_endpoint;
+    std::atomic<bool> m_isRunning { false };
+    std::intptr_t m_socket { -1 };
+    MessageCounter m_messageCounter;
+
+    // written by the main thread, read by the background thread
+    std::mutex m_mutex;
+    std::uint64_t m_nbSteps {};
+    std::uint64_t m_nbFrames {};
+    double m_stepDurationSum {};
+    double m_drawDurationSum {};
+    double m_simulatedTime {};
+    RecentDurations m_stepDurations;
+    RecentDurations m_drawDurations;
+    RecentDurations m_frameDurations;
+
+    std::thread m_thread;
+};
+
+} // namespace sofaglfw
@@ -0,0 +1,396 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaGLFW/SofaGLFWProfileRecorder.h>
+#include <SofaGLFW/SofaGLFWTimerRecords.h>
+
+#include <sofa/helper/logging/Messaging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace sofaglfw
+{
+
+namespace
+{
+    constexpr char fileMagic[8] = {'S', 'O', 'F', 'A', 'P', 'R', 'O', 'F'};
+    constexpr char labelTag = 'L';
+    constexpr char stepTag = 'S';
+
+    template<class T>
+    void writeValue(std::ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<class T>
+    bool readValue(std::istream& in, T& value)
+    {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    /// Size of an entry in the file: time, id, label id and type
+    constexpr std::uint64_t entryFileSize = sizeof(std::int64_t) + 2 * sizeof(std::uint32_t) + sizeof(std::uint8_t);
+}
+
+SofaGLFWProfileRecorder::SofaGLFWProfileRecorder(const std::string& filename)
+    : m_filename(filename)
+    , m_file(filename, std::ios::out | std::ios::binary | std::ios::trunc)
+{
+    if (!m_file.is_open())
+    {
+        msg_error("SofaGLFW") << "Cannot open the profiling file " << filename;
+        return;
+    }
+
+    m_file.write(fileMagic, sizeof(fileMagic));
+    writeValue(m_file, fileVersion);
+    writeValue(m_file, static_cast<std::int64_t>(sofa::helper::system::thread::CTime::getTicksPerSec()));
+
+    m_isOpen = true;
+    m_thread = std::thread(&SofaGLFWProfileRecorder::writeLoop, this);
+}
+
+SofaGLFWProfileRecorder::~SofaGLFWProfileRecorder()
+{
+    stop();
+}
+
+void SofaGLFWProfileRecorder::recordStep(const sofa::type::vector<sofa::helper::Record>& records)
+{
+    if (!m_isOpen)
+    {
+        return;
+    }
+
+    m_stepEntries.resize(records.size());
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        const auto& rec = records[i];
+        const auto [it, isNewLabel] = m_labelIds.try_emplace(rec.label, static_cast<std::uint32_t>(m_labelIds.size()));
+        if (isNewLabel)
+        {
+            addLabel(it->second, rec.label);
+        }
+        m_stepEntries[i] = {rec.time, rec.id, it->second, rec.type};
+    }
+    recordStep(m_stepEntries);
+}
+
+void SofaGLFWProfileRecorder::recordStep(const std::vector<Entry>& entries)
+{
+    if (!m_isOpen)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_pendingEntries.insert(m_pendingEntries.end(), entries.begin(), entries.end());
+        m_pendingStepSizes.push_back(static_cast<std::uint32_t>(entries.size()));
+    }
+    m_condition.notify_one();
+}
+
+void SofaGLFWProfileRecorder::addLabel(const std::uint32_t labelId, const std::string& label)
+{
+    std::lock_guard lock(m_mutex);
+    m_pendingLabels.emplace_back(labelId, label);
+}
+
+void SofaGLFWProfileRecorder::stop()
+{
+    if (!m_isOpen)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+
+    m_file.close();
+    if (!m_hasFailed && m_file.fail())
+    {
+        msg_error("SofaGLFW") << "Cannot write the profiling file " << m_filename;
+        m_hasFailed = true;
+    }
+    m_isOpen = false;
+}
+
+void SofaGLFWProfileRecorder::writeLoop()
+{
+    std::vector<std::pair<std::uint32_t, std::string>> labels;
+    std::vector<Entry> entries;
+    std::vector<std::uint32_t> stepSizes;
+
+    bool isStopping = false;
+    while (!isStopping)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this]{ return m_isStopping || !m_pendingStepSizes.empty() || !m_pendingLabels.empty(); });
+            std::swap(labels, m_pendingLabels);
+            std::swap(entries, m_pendingEntries);
+            std::swap(stepSizes, m_pendingStepSizes);
+            isStopping = m_isStopping;
+        }
+
+        if (m_hasFailed)
+        {
+            // the file is truncated anyway: the next steps are dropped
+            labels.clear();
+            entries.clear();
+            stepSizes.clear();
+            continue;
+        }
+
+        // the labels are written before the steps using them
+        for (const auto& [labelId, label] : labels)
+        {
+            m_file.put(labelTag);
+            writeValue(m_file, labelId);
+            writeValue(m_file, static_cast<std::uint32_t>(label.size()));
+            m_file.write(label.data(), static_cast<std::streamsize>(label.size()));
+
+            if (m_labels.size() <= labelId)
+            {
+                m_labels.resize(labelId + 1);
+            }
+            m_labels[labelId] = label;
+        }
+
+        std::size_t first = 0;
+        for (const auto stepSize : stepSizes)
+        {
+            m_file.put(stepTag);
+            writeValue(m_file, stepSize);
+            for (std::size_t i = first; i < first + stepSize; ++i)
+            {
+                const auto& entry = entries[i];
+                writeValue(m_file, static_cast<std::int64_t>(entry.time));
+                writeValue(m_file, entry.id);
+                writeValue(m_file, entry.labelId);
+                writeValue(m_file, static_cast<std::uint8_t>(entry.type));
+            }
+            summarizeStep(entries.data() + first, stepSize);
+            first += stepSize;
+        }
+
+        if (!m_file)
+        {
+            msg_error("SofaGLFW") << "Cannot write the profiling file " << m_filename
+                                  << ", the next time steps are not recorded";
+            m_hasFailed = true;
+        }
+
+        labels.clear();
+        entries.clear();
+        stepSizes.clear();
+    }
+}
+
+void SofaGLFWProfileRecorder::summarizeStep(const Entry* entries, const std::size_t nbEntries)
+{
+    if (nbEntries == 0)
+    {
+        return;
+    }
+
+    ++m_nbSteps;
+    m_totalStepTime += entries[nbEntries - 1].time - entries[0].time;
+
+    // an end record closes the innermost open interval with the same label
+    std::vector<const Entry*> openEntries;
+    std::unordered_map<std::uint32_t, sofa::helper::system::thread::ctime_t> stepTotals;
+    for (std::size_t i = 0; i < nbEntries; ++i)
+    {
+        const auto& entry = entries[i];
+        if (isBeginRecord(entry.type))
+        {
+            openEntries.push_back(&entry);
+        }
+        else if (isEndRecord(entry.type))
+        {
+            const auto it = std::find_if(openEntries.rbegin(), openEntries.rend(), [&entry](const Entry* open)
+            {
+                return open->labelId == entry.labelId;
+            });
+            if (it != openEntries.rend())
+            {
+                stepTotals[entry.labelId] += entry.time - (*it)->time;
+                ++m_summaries[entry.labelId].nbCalls;
+                openEntries.erase(std::next(it).base(), openEntries.end());
+            }
+        }
+    }
+
+    for (const auto& [labelId, total] : stepTotals)
+    {
+        auto& summary = m_summaries[labelId];
+        ++summary.nbSteps;
+        summary.total += total;
+        summary.max = std::max(summary.max, total);
+    }
+}
+
+void SofaGLFWProfileRecorder::logSummary() const
+{
+    if (m_nbSteps == 0)
+    {
+        msg_info("SofaGLFW") << "Profiling: no time step recorded in " << m_filename;
+        return;
+    }
+
+    const auto ticksPerMillisecond = static_cast<double>(sofa::helper::system::thread::CTime::getTicksPerSec()) / 1000.;
+    const auto toMilliseconds = [ticksPerMillisecond](const sofa::helper::system::thread::ctime_t t)
+    {
+        return static_cast<double>(t) / ticksPerMillisecond;
+    };
+
+    std::vector<std::pair<std::uint32_t, TimerSummary>> summaries(m_summaries.begin(), m_summaries.end());
+    std::sort(summaries.begin(), summaries.end(), [](const auto& a, const auto& b)
+    {
+        return a.second.total > b.second.total;
+    });
+
+    constexpr std::size_t maxNbLines = 30;
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(3);
+    summary << "Profiling: " << m_nbSteps << " time steps recorded in " << m_filename
+            << ", average step duration: " << toMilliseconds(m_totalStepTime) / static_cast<double>(m_nbSteps) << " ms" << msgendl;
+    summary << std::setw(12) << "total (ms)" << std::setw(14) << "per step (ms)" << std::setw(12) << "max (ms)"
+            << std::setw(10) << "calls" << std::setw(10) << "share %" << "  label" << msgendl;
+    for (std::size_t i = 0; i < std::min(maxNbLines, summaries.size()); ++i)
+    {
+        const auto& [labelId, timer] = summaries[i];
+        summary << std::setw(12) << toMilliseconds(timer.total)
+                << std::setw(14) << toMilliseconds(timer.total) / static_cast<double>(m_nbSteps)
+                << std::setw(12) << toMilliseconds(timer.max)
+                << std::setw(10) << timer.nbCalls
+                << std::setw(10) << std::setprecision(2) << 100. * static_cast<double>(timer.total) / static_cast<double>(std::max<sofa::helper::system::thread::ctime_t>(1, m_totalStepTime)) << std::setprecision(3)
+                << "  " << (labelId < m_labels.size() ? m_labels[labelId] : std::string("?")) << msgendl;
+    }
+    msg_info("SofaGLFW") << summary.str();
+}
+
+bool SofaGLFWProfileRecorder::read(const std::string& filename,
+                                   std::vector<std::string>& labels,
+                                   std::vector<std::vector<Entry>>& steps,
+                                   sofa::helper::system::thread::ctime_t& ticksPerSecond)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        msg_error("SofaGLFW") << "Cannot open the profiling file " << filename;
+        return false;
+    }
+    const auto fileSize = static_cast<std::uint64_t>(file.tellg());
+    file.seekg(0);
+
+    char magic[sizeof(fileMagic)];
+    std::uint32_t version {};
+    std::int64_t ticks {};
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, fileMagic, sizeof(fileMagic)) != 0
+        || !readValue(file, version) || version != fileVersion || !readValue(file, ticks))
+    {
+        msg_error("SofaGLFW") << filename << " is not a profiling file of version " << fileVersion;
+        return false;
+    }
+    ticksPerSecond = static_cast<sofa::helper::system::thread::ctime_t>(ticks);
+
+    labels.clear();
+    steps.clear();
+
+    // the sizes read from the file are checked against the bytes left before anything is allocated,
+    // so that a corrupted file is rejected instead of exhausting the memory
+    const auto corrupted = [&]()
+    {
+        msg_error("SofaGLFW") << filename << " is corrupted";
+        labels.clear();
+        steps.clear();
+        return false;
+    };
+    const auto remainingSize = [&]() { return fileSize - static_cast<std::uint64_t>(file.tellg()); };
+
+    char tag {};
+    while (file.get(tag))
+    {
+        if (tag == labelTag)
+        {
+            // the recorder numbers the labels in the order they are written
+            std::uint32_t labelId {};
+            std::uint32_t size {};
+            if (!readValue(file, labelId) || !readValue(file, size)
+                || labelId > labels.size() || size > remainingSize())
+            {
+                return corrupted();
+            }
+            std::string label(size, '\0');
+            if (!file.read(label.data(), size))
+            {
+                return corrupted();
+            }
+            if (labelId == labels.size())
+            {
+                labels.push_back(std::move(label));
+            }
+            else
+            {
+                labels[labelId] = std::move(label);
+            }
+        }
+        else if (tag == stepTag)
+        {
+            std::uint32_t nbEntries {};
+            if (!readValue(file, nbEntries) || nbEntries > remainingSize() / entryFileSize)
+            {
+                return corrupted();
+            }
+            auto& step = steps.emplace_back(nbEntries);
+            for (auto& entry : step)
+            {
+                std::int64_t time {};
+                std::uint8_t type {};
+                if (!readValue(file, time) || !readValue(file, entry.id) || !readValue(file, entry.labelId) || !readValue(file, type)
+                    || entry.labelId >= labels.size())
+                {
+                    return corrupted();
+                }
+                entry.time = static_cast<sofa::helper::system::thread::ctime_t>(time);
+                entry.type = static_cast<sofa::helper::Record::Type>(type);
+            }
+        }
+        else
+        {
+            return corrupted();
+        }
+    }
+    return true;
+}
+
+} // namespace sofaglfw
@@ -0,0 +1,131 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaGLFW/config.h>
+
+#include <sofa/helper/AdvancedTimer.h>
+#include <sofa/type/vector.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sofaglfw
+{
+
+/**
+ * Records the AdvancedTimer records of each time step in a compact binary file, from a background
+ * thread, and logs a summary of the timers when it is stopped.
+ *
+ * File format (native endianness):
+ * - header: the 8 characters "SOFAPROF", the format version (uint32) and the timer ticks per second (int64)
+ * - then a sequence of chunks, starting with a tag byte:
+ *   - 'L': a label, defined once before its first use: label id (uint32), size (uint32), characters
+ *   - 'S': a time step: number of entries (uint32), then for each entry:
+ *          time (int64), timer id (uint32), label id (uint32), record type (uint8)
+ */
+class SOFAGLFW_API SofaGLFWProfileRecorder
+{
+public:
+    static constexpr std::uint32_t fileVersion = 1;
+
+    struct Entry
+    {
+        sofa::helper::system::thread::ctime_t time {};
+        std::uint32_t id {};
+        std::uint32_t labelId {};
+        sofa::helper::Record::Type type { sofa::helper::Record::RNONE };
+    };
+
+    explicit SofaGLFWProfileRecorder(const std::string& filename);
+    ~SofaGLFWProfileRecorder();
+
+    SofaGLFWProfileRecorder(const SofaGLFWProfileRecorder&) = delete;
+    SofaGLFWProfileRecorder& operator=(const SofaGLFWProfileRecorder&) = delete;
+
+    bool isOpen() const { return m_isOpen; }
+
+    /// Converts the records of a time step and hands them to the writing thread
+    void recordStep(const sofa::type::vector<sofa::helper::Record>& records);
+
+    /// Hands a time step already converted to entries. The labels must have been declared with addLabel.
+    void recordStep(const std::vector<Entry>& entries);
+    void addLabel(std::uint32_t labelId, const std::string& label);
+
+    /// Writes the pending steps and closes the file
+    void stop();
+
+    /// True if the file could not be written completely. Valid after stop().
+    bool hasFailed() const { return m_hasFailed; }
+
+    /// Logs a summary of the timers of the recorded steps. Call it after stop().
+    void logSummary() const;
+
+    /// Reads a file written by a recorder. Returns false if it cannot be read or is corrupted.
+    static bool read(const std::string& filename,
+                     std::vector<std::string>& labels,
+                     std::vector<std::vector<Entry>>& steps,
+                     sofa::helper::system::thread::ctime_t& ticksPerSecond);
+
+private:
+    struct TimerSummary
+    {
+        std::size_t nbCalls {};
+        std::size_t nbSteps {};
+        sofa::helper::system::thread::ctime_t total {};
+        sofa::helper::system::thread::ctime_t max {}; ///< longest step
+    };
+
+    void writeLoop();
+    void summarizeStep(const Entry* entries, std::size_t nbEntries);
+
+    std::string m_filename;
+    bool m_isOpen { false };
+
+    // main thread
+    std::unordered_map<std::string, std::uint32_t> m_labelIds;
+    std::vector<Entry> m_stepEntries;
+
+    // shared with the writing thread, protected by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<std::pair<std::uint32_t, std::string>> m_pendingLabels;
+    std::vector<Entry> m_pendingEntries;
+    std::vector<std::uint32_t> m_pendingStepSizes;
+    bool m_isStopping { false };
+
+    // writing thread
+    std::ofstream m_file;
+    bool m_hasFailed { false }; ///< the file stopped being written after an error
+    std::vector<std::string> m_labels;
+    std::unordered_map<std::uint32_t, TimerSummary> m_summaries;
+    std::size_t m_nbSteps {};
+    sofa::helper::system::thread::ctime_t m_totalStepTime {};
+    std::thread m_thread;
+};
+
+} // namespace sofaglfw
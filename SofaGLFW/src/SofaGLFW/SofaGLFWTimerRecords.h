@@ -0,0 +1,42 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaGLFW/config.h>
+
+#include <sofa/helper/AdvancedTimer.h>
+
+namespace sofaglfw
+{
+
+/// True for the records of the AdvancedTimer opening a timer interval
+inline bool isBeginRecord(const sofa::helper::Record::Type type)
+{
+    return type == sofa::helper::Record::RBEGIN || type == sofa::helper::Record::RSTEP_BEGIN || type == sofa::helper::Record::RSTEP;
+}
+
+/// True for the records of the AdvancedTimer closing a timer interval
+inline bool isEndRecord(const sofa::helper::Record::Type type)
+{
+    return type == sofa::helper::Record::REND || type == sofa::helper::Record::RSTEP_END;
+}
+
+} // namespace sofaglfw
@@ -0,0 +1,168 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaGLFW/SofaGLFWTraceWriter.h>
+#include <SofaGLFW/SofaGLFWTimerRecords.h>
+
+#include <sofa/helper/logging/Messaging.h>
+
+#include <algorithm>
+#include <iomanip>
+
+namespace sofaglfw
+{
+
+namespace
+{
+    void writeEscaped(std::ostream& out, const std::string& text)
+    {
+        for (const char c : text)
+        {
+            switch (c)
+            {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+                    }
+                    else
+                    {
+                        out << c;
+                    }
+            }
+        }
+    }
+}
+
+SofaGLFWTraceWriter::SofaGLFWTraceWriter(const std::string& filename)
+    : m_filename(filename)
+    , m_file(filename, std::ios::out | std::ios::trunc)
+{
+    if (!m_file.is_open())
+    {
+        msg_error("SofaGLFW") << "Cannot open the trace file " << filename;
+        return;
+    }
+    m_file << std::fixed << std::setprecision(3);
+    m_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+}
+
+SofaGLFWTraceWriter::~SofaGLFWTraceWriter()
+{
+    close();
+}
+
+void SofaGLFWTraceWriter::writeStep(const sofa::type::vector<sofa::helper::Record>& records)
+{
+    if (records.empty())
+    {
+        return;
+    }
+
+    for (const auto& rec : records)
+    {
+        if (isBeginRecord(rec.type))
+        {
+            beginEvent(rec.label, rec.time);
+        }
+        else if (isEndRecord(rec.type))
+        {
+            endEvent(rec.label, rec.time);
+        }
+    }
+    endAllEvents(records.back().time);
+}
+
+void SofaGLFWTraceWriter::beginEvent(const std::string& name, const sofa::helper::system::thread::ctime_t time)
+{
+    writeEvent(name, 'B', time);
+    m_openEvents.push_back(name);
+}
+
+void SofaGLFWTraceWriter::endEvent(const sofa::helper::system::thread::ctime_t time)
+{
+    if (m_openEvents.empty())
+    {
+        return;
+    }
+    writeEvent(m_openEvents.back(), 'E', time);
+    m_openEvents.pop_back();
+}
+
+void SofaGLFWTraceWriter::endEvent(const std::string& name, const sofa::helper::system::thread::ctime_t time)
+{
+    const auto it = std::find(m_openEvents.rbegin(), m_openEvents.rend(), name);
+    if (it == m_openEvents.rend())
+    {
+        return;
+    }
+
+    const auto nbClosedEvents = std::distance(m_openEvents.rbegin(), it) + 1;
+    for (auto i = 0; i < nbClosedEvents; ++i)
+    {
+        endEvent(time);
+    }
+}
+
+void SofaGLFWTraceWriter::endAllEvents(const sofa::helper::system::thread::ctime_t time)
+{
+    while (!m_openEvents.empty())
+    {
+        endEvent(time);
+    }
+}
+
+void SofaGLFWTraceWriter::close()
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+
+    m_file << "\n]}\n";
+    m_file.close();
+    msg_info("SofaGLFW") << m_nbEvents << " trace events written in " << m_filename;
+}
+
+void SofaGLFWTraceWriter::writeEvent(const std::string& name, const char phase, const sofa::helper::system::thread::ctime_t time)
+{
+    if (!m_file.is_open())
+    {
+        return;
+    }
+
+    static const auto ticksPerMicrosecond = static_cast<double>(sofa::helper::system::thread::CTime::getTicksPerSec()) / 1e6;
+
+    if (m_nbEvents > 0)
+    {
+        m_file << ",\n";
+    }
+    m_file << "{\"name\":\"";
+    writeEscaped(m_file, name);
+    m_file << "\",\"ph\":\"" << phase << "\",\"ts\":" << static_cast<double>(time) / ticksPerMicrosecond << ",\"pid\":1,\"tid\":1}";
+    ++m_nbEvents;
+}
+
+} // namespace sofaglfw
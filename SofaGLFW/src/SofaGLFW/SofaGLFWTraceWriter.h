@@ -0,0 +1,81 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaGLFW/config.h>
+
+#include <sofa/helper/AdvancedTimer.h>
+#include <sofa/type/vector.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace sofaglfw
+{
+
+/**
+ * Writes AdvancedTimer records in the Chrome Trace Event format (JSON), which can be opened in
+ * Perfetto (ui.perfetto.dev) or chrome://tracing.
+ *
+ * Each timer interval becomes a pair of nested begin/end events. The timestamps are the times of the
+ * records converted in microseconds, without offset, so that they can be correlated with other tools.
+ * The file is completed when the writer is closed or destroyed.
+ */
+class SOFAGLFW_API SofaGLFWTraceWriter
+{
+public:
+    explicit SofaGLFWTraceWriter(const std::string& filename);
+    ~SofaGLFWTraceWriter();
+
+    SofaGLFWTraceWriter(const SofaGLFWTraceWriter&) = delete;
+    SofaGLFWTraceWriter& operator=(const SofaGLFWTraceWriter&) = delete;
+
+    bool isOpen() const { return m_file.is_open(); }
+    const std::string& getFilename() const { return m_filename; }
+
+    /// Writes the records of a time step. Intervals left open by the step are closed at its last record.
+    void writeStep(const sofa::type::vector<sofa::helper::Record>& records);
+
+    /// Opens a nested interval
+    void beginEvent(const std::string& name, sofa::helper::system::thread::ctime_t time);
+    /// Closes the innermost open interval. Ignored if no interval is open.
+    void endEvent(sofa::helper::system::thread::ctime_t time);
+    /// Closes the innermost open interval with this name, and the intervals left open inside it. Ignored if there is none.
+    void endEvent(const std::string& name, sofa::helper::system::thread::ctime_t time);
+    /// Closes all the open intervals
+    void endAllEvents(sofa::helper::system::thread::ctime_t time);
+
+    /// Completes the file
+    void close();
+
+    std::size_t getNbEvents() const { return m_nbEvents; }
+
+private:
+    void writeEvent(const std::string& name, char phase, sofa::helper::system::thread::ctime_t time);
+
+    std::string m_filename;
+    std::ofstream m_file;
+    std::vector<std::string> m_openEvents;
+    std::size_t m_nbEvents {};
+};
+
+} // namespace sofaglfw
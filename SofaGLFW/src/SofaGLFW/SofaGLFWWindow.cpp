@@ -32,11 +32,29 @@
 #include <sofa/core/objectmodel/MouseEvent.h>
 #include <sofa/simulation/Simulation.h>
 #include <sofa/simulation/Node.h>
+#include <sofa/component/visual/VisualStyle.h>
 #include <sofa/gl/gl.h>
 
+#include <algorithm>
+
 using namespace sofa;
 namespace sofaglfw
 {
+
+namespace
+{
+
+int getDisplayFlagsCounter(const simulation::Node* groot)
+{
+    if (const auto* visualStyle = groot->get<component::visual::VisualStyle>())
+    {
+        return visualStyle->d_displayFlags.getCounter();
+    }
+    return -1;
+}
+
+}
+
 SofaGLFWWindow::SofaGLFWWindow(GLFWwindow* glfwWindow, component::visual::BaseCamera::SPtr camera)
         : m_glfwWindow(glfwWindow)
         , m_currentCamera(camera)
@@ -82,7 +100,7 @@ void SofaGLFWWindow::draw(simulation::NodeSPtr groot, core::visual::VisualParams
     m_currentCamera->getOpenGLProjectionMatrix(lastProjectionMatrix);
     m_currentCamera->getOpenGLModelViewMatrix(lastModelviewMatrix);
 
-    glViewport(0, 0, vparams->viewport()[2], vparams->viewport()[3]);
+    glViewport(vparams->viewport()[0], vparams->viewport()[1], vparams->viewport()[2], vparams->viewport()[3]);
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
     glMultMatrixd(lastProjectionMatrix);
@@ -98,16 +116,55 @@ void SofaGLFWWindow::draw(simulation::NodeSPtr groot, core::visual::VisualParams
     vparams->setModelViewMatrix(lastModelviewMatrix);
 
     simulation::node::draw(vparams, groot.get());
+
+    m_lastSceneImageState.isValid = true;
+    m_lastSceneImageState.root = groot.get();
+    m_lastSceneImageState.time = groot->getTime();
+    std::copy_n(vparams->viewport().begin(), 4, m_lastSceneImageState.viewport.begin());
+    std::copy_n(lastModelviewMatrix, 16, m_lastSceneImageState.modelViewMatrix.begin());
+    std::copy_n(lastProjectionMatrix, 16, m_lastSceneImageState.projectionMatrix.begin());
+    m_lastSceneImageState.displayFlagsCounter = getDisplayFlagsCounter(groot.get());
+}
+
+bool SofaGLFWWindow::isSceneImageOutdated(simulation::NodeSPtr groot, const core::visual::VisualParams* vparams) const
+{
+    const auto& state = m_lastSceneImageState;
+    if (!state.isValid || !m_currentCamera || !groot)
+        return true;
+
+    if (groot->getAnimate() || state.root != groot.get() || state.time != groot->getTime())
+        return true;
+
+    if (!std::equal(state.viewport.begin(), state.viewport.end(), vparams->viewport().begin()))
+        return true;
+
+    if (state.displayFlagsCounter != getDisplayFlagsCounter(groot.get()))
+        return true;
+
+    double modelviewMatrix[16];
+    double projectionMatrix[16];
+    m_currentCamera->getOpenGLModelViewMatrix(modelviewMatrix);
+    m_currentCamera->getOpenGLProjectionMatrix(projectionMatrix);
+
+    return !std::equal(state.modelViewMatrix.begin(), state.modelViewMatrix.end(), modelviewMatrix)
+        || !std::equal(state.projectionMatrix.begin(), state.projectionMatrix.end(), projectionMatrix);
+}
+
+void SofaGLFWWindow::invalidateSceneImage()
+{
+    m_lastSceneImageState.isValid = false;
 }
 
 void SofaGLFWWindow::setBackgroundColor(const RGBAColor& newColor)
 {
     m_backgroundColor = newColor;
+    invalidateSceneImage();
 }
 
 void SofaGLFWWindow::setCamera(component::visual::BaseCamera::SPtr newCamera)
 {
     m_currentCamera = newCamera;
+    invalidateSceneImage();
 }
 
 void SofaGLFWWindow::centerCamera(simulation::NodeSPtr node, core::visual::VisualParams* vparams) const
@@ -139,45 +196,35 @@ void SofaGLFWWindow::mouseMoveEvent(int xpos, int ypos, SofaGLFWBaseGUI* gui)
     {
         case GLFW_PRESS:
         {
-            core::objectmodel::MouseEvent* mEvent = nullptr;
+            auto state = core::objectmodel::MouseEvent::AnyExtraButtonPressed; // A fallback event to rule them all...
             if (m_currentButton == GLFW_MOUSE_BUTTON_LEFT)
-                mEvent = new core::objectmodel::MouseEvent(core::objectmodel::MouseEvent::LeftPressed, xpos, ypos);
+                state = core::objectmodel::MouseEvent::LeftPressed;
             else if (m_currentButton == GLFW_MOUSE_BUTTON_RIGHT)
-                mEvent = new core::objectmodel::MouseEvent(core::objectmodel::MouseEvent::RightPressed, xpos, ypos);
+                state = core::objectmodel::MouseEvent::RightPressed;
             else if (m_currentButton == GLFW_MOUSE_BUTTON_MIDDLE)
-                mEvent = new core::objectmodel::MouseEvent(core::objectmodel::MouseEvent::MiddlePressed, xpos, ypos);
-            else
-            {
-                // A fallback event to rule them all...
-                mEvent = new core::objectmodel::MouseEvent(core::objectmodel::MouseEvent::AnyExtraButtonPressed, xpos, ypos);
-            }
-            m_currentCamera->manageEvent(mEvent);
+                state = core::objectmodel::MouseEvent::MiddlePressed;
 
-            auto rootNode = gui->getRootNode();
+            core::objectmodel::MouseEvent mEvent(state, xpos, ypos);
+            m_currentCamera->manageEvent(&mEvent);
 
-            rootNode->propagateEvent(core::execparams::defaultInstance(), mEvent);
+            gui->propagateEvent(&mEvent);
 
             break;
         }
         case GLFW_RELEASE:
         {
-            core::objectmodel::MouseEvent* mEvent = nullptr;
+            auto state = core::objectmodel::MouseEvent::AnyExtraButtonReleased; // A fallback event to rules them all...
             if (m_currentButton == GLFW_MOUSE_BUTTON_LEFT)
-                mEvent = new core::objectmodel::MouseEvent(core::objectmodel::MouseEvent::LeftReleased, xpos, ypos);
+                state = core::objectmodel::MouseEvent::LeftReleased;
             else if (m_currentButton == GLFW_MOUSE_BUTTON_RIGHT)
-                mEvent = new core::objectmodel::MouseEvent(core::objectmodel::MouseEvent::RightReleased, xpos, ypos);
+                state = core::objectmodel::MouseEvent::RightReleased;
             else if (m_currentButton == GLFW_MOUSE_BUTTON_MIDDLE)
-                mEvent = new core::objectmodel::MouseEvent(core::objectmodel::MouseEvent::MiddleReleased, xpos, ypos);
-            else
-            {
-                // A fallback event to rules them all...
-                mEvent = new core::objectmodel::MouseEvent(core::objectmodel::MouseEvent::AnyExtraButtonReleased, xpos, ypos);
-            }
-            m_currentCamera->manageEvent(mEvent);
+                state = core::objectmodel::MouseEvent::MiddleReleased;
 
-            auto rootNode = gui->getRootNode();
+            core::objectmodel::MouseEvent mEvent(state, xpos, ypos);
+            m_currentCamera->manageEvent(&mEvent);
 
-            rootNode->propagateEvent(core::execparams::defaultInstance(), mEvent);
+            gui->propagateEvent(&mEvent);
 
             break;
         }
@@ -193,6 +240,25 @@ void SofaGLFWWindow::mouseMoveEvent(int xpos, int ypos, SofaGLFWBaseGUI* gui)
     m_currentAction = -1;
     m_currentMods = -1;
 }
+
+void SofaGLFWWindow::queueMouseMove(double xpos, double ypos)
+{
+    m_hasQueuedMouseMove = true;
+    m_queuedXPos = xpos;
+    m_queuedYPos = ypos;
+}
+
+bool SofaGLFWWindow::popQueuedMouseMove(double& xpos, double& ypos)
+{
+    if (!m_hasQueuedMouseMove)
+        return false;
+
+    m_hasQueuedMouseMove = false;
+    xpos = m_queuedXPos;
+    ypos = m_queuedYPos;
+    return true;
+}
+
 void SofaGLFWWindow::mouseButtonEvent(int button, int action, int mods)
 {
     // Only change state on button press; release resets state to neutral
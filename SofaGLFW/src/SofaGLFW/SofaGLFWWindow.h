@@ -26,6 +26,8 @@
 #include <sofa/component/visual/BaseCamera.h>
 #include "SofaGLFWBaseGUI.h"
 
+#include <array>
+
 struct GLFWwindow;
 
 namespace sofaglfw
@@ -41,6 +43,10 @@ public:
     void close();
 
     void mouseMoveEvent(int xpos, int ypos,SofaGLFWBaseGUI* gui);
+    /// Keeps the last cursor position reported by GLFW: moves are coalesced and dispatched once per frame
+    void queueMouseMove(double xpos, double ypos);
+    /// Returns true and the last queued cursor position if a move has been queued since the previous call
+    bool popQueuedMouseMove(double& xpos, double& ypos);
     void mouseButtonEvent(int button, int action, int mods);
     void scrollEvent(double xoffset, double yoffset);
     void setBackgroundColor(const RGBAColor& newColor);
@@ -49,7 +55,25 @@ public:
     void centerCamera(sofa::simulation::NodeSPtr node, sofa::core::visual::VisualParams* vparams) const;
     bool mouseEvent(GLFWwindow* window,int width,int height ,int button, int action, int mods, double xpos, double ypos) const;
 
+    /// Returns true if the scene must be drawn again: the simulation is running, or the camera, the viewport,
+    /// the simulation time or the display flags changed since the last draw
+    bool isSceneImageOutdated(sofa::simulation::NodeSPtr groot, const sofa::core::visual::VisualParams* vparams) const;
+    /// Forces the scene to be drawn again at the next frame
+    void invalidateSceneImage();
+
 private:
+    /// State of the scene when it was drawn for the last time
+    struct SceneImageState
+    {
+        bool isValid { false };
+        const sofa::simulation::Node* root { nullptr };
+        SReal time {};
+        std::array<int, 4> viewport {};
+        std::array<double, 16> modelViewMatrix {};
+        std::array<double, 16> projectionMatrix {};
+        int displayFlagsCounter { -1 };
+    };
+
     GLFWwindow* m_glfwWindow{nullptr};
     sofa::component::visual::BaseCamera::SPtr m_currentCamera;
     int m_currentButton{ -1 };
@@ -57,7 +81,11 @@ private:
     int m_currentMods{ -1 };
     int m_currentXPos{ -1 };
     int m_currentYPos{ -1 };
+    bool m_hasQueuedMouseMove{ false };
+    double m_queuedXPos{ 0. };
+    double m_queuedYPos{ 0. };
     RGBAColor m_backgroundColor{ RGBAColor::black() };
+    SceneImageState m_lastSceneImageState;
 };
 
 } // namespace sofaglfw
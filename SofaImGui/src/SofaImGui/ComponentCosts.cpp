@@ -0,0 +1,255 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/ComponentCosts.h>
+#include <SofaImGui/ProfilerCapture.h>
+
+#include <algorithm>
+
+namespace sofaimgui
+{
+
+ComponentCosts::~ComponentCosts()
+{
+    clear();
+}
+
+void ComponentCosts::setEnabled(const bool isEnabled)
+{
+    if (isEnabled != m_isEnabled)
+    {
+        m_isEnabled = isEnabled;
+        clear();
+    }
+}
+
+void ComponentCosts::update(sofa::simulation::Node* root)
+{
+    if (root == nullptr)
+    {
+        return;
+    }
+
+    if (root != m_root.get())
+    {
+        clear();
+        m_root = sofa::simulation::Node::SPtr(root);
+        m_graphListener.attach(root);
+        m_graphListener.isGraphModified = true;
+    }
+
+    if (m_graphListener.isGraphModified)
+    {
+        m_graphListener.isGraphModified = false;
+        m_objectsByName.clear();
+        m_objectsByLabel.clear();
+        m_nbMappedLabels = 0;
+        std::unordered_set<const sofa::core::objectmodel::BaseObject*> objects;
+        indexNames(root, objects);
+
+        // the address of a removed component may be reused by a new one, which must not inherit its cost
+        for (auto it = m_objectCosts.begin(); it != m_objectCosts.end();)
+        {
+            if (objects.find(it->first) == objects.end())
+            {
+                it = m_objectCosts.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    m_nodeCosts.clear();
+    computeSubtreeCost(root);
+}
+
+void ComponentCosts::indexNames(sofa::simulation::Node* node, std::unordered_set<const sofa::core::objectmodel::BaseObject*>& objects)
+{
+    for (const auto object : node->getNodeObjects())
+    {
+        const auto [it, isNewName] = m_objectsByName.try_emplace(object->getName(), object);
+        if (!isNewName && it->second != object)
+        {
+            it->second = nullptr;
+        }
+        objects.insert(object);
+    }
+    for (const auto child : node->getChildren())
+    {
+        auto* childNode = dynamic_cast<sofa::simulation::Node*>(child);
+        if (childNode && childNode->getFirstParent() == node)
+        {
+            indexNames(childNode, objects);
+        }
+    }
+}
+
+float ComponentCosts::computeSubtreeCost(sofa::simulation::Node* node)
+{
+    float cost = 0.f;
+    for (const auto object : node->getNodeObjects())
+    {
+        cost += getObjectCost(object);
+    }
+    // a node with several parents is counted in the subtree of its first parent
+    for (const auto child : node->getChildren())
+    {
+        auto* childNode = dynamic_cast<sofa::simulation::Node*>(child);
+        if (childNode && childNode->getFirstParent() == node)
+        {
+            cost += computeSubtreeCost(childNode);
+        }
+    }
+    m_nodeCosts[node] = cost;
+    return cost;
+}
+
+const sofa::core::objectmodel::BaseObject* ComponentCosts::findObject(const std::string& label)
+{
+    const auto [cached, isNewLabel] = m_objectsByLabel.try_emplace(label, nullptr);
+    if (!isNewLabel)
+    {
+        return cached->second;
+    }
+
+    // the whole label, then the longest suffix following a space
+    const sofa::core::objectmodel::BaseObject* object = nullptr;
+    std::size_t position = 0;
+    std::string name = label;
+    while (true)
+    {
+        const auto it = m_objectsByName.find(name);
+        if (it != m_objectsByName.end())
+        {
+            object = it->second;
+            break;
+        }
+        position = label.find(' ', position);
+        if (position == std::string::npos)
+        {
+            break;
+        }
+        name = label.substr(++position);
+    }
+
+    if (object)
+    {
+        ++m_nbMappedLabels;
+    }
+    cached->second = object;
+    return object;
+}
+
+void ComponentCosts::addStep(const Records& records)
+{
+    m_stepCosts.clear();
+    m_openObjects.clear();
+    m_openRecords.clear();
+
+    // an end record closes the innermost open interval with the same label. The time of the intervals
+    // nested in an interval of the same component is not counted twice.
+    for (const auto& record : records)
+    {
+        if (sofaglfw::isBeginRecord(record.type))
+        {
+            const auto* object = findObject(record.label);
+            m_openRecords.emplace_back(&record, object);
+            if (object)
+            {
+                ++m_openObjects[object];
+            }
+        }
+        else if (sofaglfw::isEndRecord(record.type))
+        {
+            const auto it = std::find_if(m_openRecords.rbegin(), m_openRecords.rend(), [&record](const auto& open)
+            {
+                return open.first->label == record.label;
+            });
+            if (it == m_openRecords.rend())
+            {
+                continue;
+            }
+            for (auto closed = m_openRecords.rbegin(); closed != std::next(it); ++closed)
+            {
+                if (const auto* object = closed->second; object && --m_openObjects[object] == 0)
+                {
+                    m_stepCosts[object] += static_cast<float>(ProfilerCapture::toMilliseconds(record.time - closed->first->time));
+                }
+            }
+            m_openRecords.erase(std::next(it).base(), m_openRecords.end());
+        }
+    }
+
+    // the components which are not recorded anymore are forgotten once their cost is negligible
+    for (auto it = m_objectCosts.begin(); it != m_objectCosts.end();)
+    {
+        it->second *= 1.f - smoothingFactor;
+        if (it->second < 1e-6f && m_stepCosts.find(it->first) == m_stepCosts.end())
+        {
+            it = m_objectCosts.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    for (const auto& [object, cost] : m_stepCosts)
+    {
+        m_objectCosts[object] += smoothingFactor * cost;
+    }
+
+    m_maxObjectCost = 0.f;
+    for (const auto& [object, cost] : m_objectCosts)
+    {
+        m_maxObjectCost = std::max(m_maxObjectCost, cost);
+    }
+}
+
+void ComponentCosts::clear()
+{
+    if (m_root)
+    {
+        m_graphListener.detach(m_root.get());
+    }
+    m_root = nullptr;
+    m_objectsByName.clear();
+    m_objectsByLabel.clear();
+    m_nbMappedLabels = 0;
+    m_objectCosts.clear();
+    m_nodeCosts.clear();
+    m_maxObjectCost = 0.f;
+}
+
+float ComponentCosts::getObjectCost(const sofa::core::objectmodel::BaseObject* object) const
+{
+    const auto it = m_objectCosts.find(object);
+    return it != m_objectCosts.end() ? it->second : 0.f;
+}
+
+float ComponentCosts::getNodeCost(const sofa::simulation::Node* node) const
+{
+    const auto it = m_nodeCosts.find(node);
+    return it != m_nodeCosts.end() ? it->second : 0.f;
+}
+
+} // namespace sofaimgui
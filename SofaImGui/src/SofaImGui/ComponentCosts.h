@@ -0,0 +1,108 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+
+#include <SofaGLFW/SofaGLFWGraphListener.h>
+
+#include <sofa/helper/AdvancedTimer.h>
+#include <sofa/simulation/Node.h>
+#include <sofa/type/vector.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace sofaimgui
+{
+
+/**
+ * Cost of the components of a scene graph, estimated from the AdvancedTimer records of the steps.
+ *
+ * A timer label is attributed to a component when it is the name of the component, or when it ends
+ * with a space followed by the name (as the labels of AdvancedTimer::stepBegin(id, object)). The
+ * labels matching several components of the same name are not attributed. The cost of a component
+ * is the time spent in its timers, averaged over the last steps with an exponential moving average.
+ *
+ * The names are indexed again each time a component or a node is added to or removed from the graph.
+ */
+class SOFAIMGUI_API ComponentCosts
+{
+public:
+    using Records = sofa::type::vector<sofa::helper::Record>;
+
+    /// Weight of the last step in the moving average
+    static constexpr float smoothingFactor = 0.05f;
+
+    ComponentCosts() = default;
+    ~ComponentCosts();
+
+    ComponentCosts(const ComponentCosts&) = delete;
+    ComponentCosts& operator=(const ComponentCosts&) = delete;
+
+    void setEnabled(bool isEnabled);
+    bool isEnabled() const { return m_isEnabled; }
+
+    /// Indexes the names of the components if the graph changed, and computes the costs of the
+    /// subtrees. To call before reading the costs.
+    void update(sofa::simulation::Node* root);
+
+    /// Accumulates the records of a step
+    void addStep(const Records& records);
+
+    void clear();
+
+    /// Mean cost per step (ms) of a component, 0 if none of its timers was recorded
+    float getObjectCost(const sofa::core::objectmodel::BaseObject* object) const;
+    /// Mean cost per step (ms) of the components of a node and of its descendants
+    float getNodeCost(const sofa::simulation::Node* node) const;
+    /// Highest cost of a component, to scale the colors
+    float getMaxObjectCost() const { return m_maxObjectCost; }
+
+    std::size_t getNbMappedLabels() const { return m_nbMappedLabels; }
+
+private:
+    void indexNames(sofa::simulation::Node* node, std::unordered_set<const sofa::core::objectmodel::BaseObject*>& objects);
+    float computeSubtreeCost(sofa::simulation::Node* node);
+    const sofa::core::objectmodel::BaseObject* findObject(const std::string& label);
+
+    bool m_isEnabled { false };
+
+    sofa::simulation::Node::SPtr m_root;
+    sofaglfw::SofaGLFWGraphListener m_graphListener;
+    /// the name of several components is mapped to nullptr
+    std::unordered_map<std::string, const sofa::core::objectmodel::BaseObject*> m_objectsByName;
+    std::unordered_map<std::string, const sofa::core::objectmodel::BaseObject*> m_objectsByLabel;
+    std::size_t m_nbMappedLabels {};
+
+    // the components are only used as keys: they are never dereferenced
+    std::unordered_map<const sofa::core::objectmodel::BaseObject*, float> m_objectCosts;
+    std::unordered_map<const sofa::simulation::Node*, float> m_nodeCosts;
+    float m_maxObjectCost {};
+
+    std::unordered_map<const sofa::core::objectmodel::BaseObject*, float> m_stepCosts;
+    std::unordered_map<const sofa::core::objectmodel::BaseObject*, unsigned int> m_openObjects;
+    std::vector<std::pair<const sofa::helper::Record*, const sofa::core::objectmodel::BaseObject*>> m_openRecords;
+};
+
+} // namespace sofaimgui
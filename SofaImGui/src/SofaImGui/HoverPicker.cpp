@@ -0,0 +1,542 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/HoverPicker.h>
+
+#include <sofa/component/visual/VisualModelImpl.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <set>
+
+namespace sofaimgui
+{
+
+namespace
+{
+    constexpr unsigned int maxLeafSize = 4;
+
+    /// Counter of a Data of the object, or -1 if the object has no Data with this name
+    int getDataCounter(const sofa::core::objectmodel::BaseObject* object, const char* dataName)
+    {
+        const auto* data = object->findData(dataName);
+        return data ? data->getCounter() : -1;
+    }
+
+    bool intersectBox(const TriangleBVH::Vec3& origin, const TriangleBVH::Vec3& inverseDirection,
+                      const TriangleBVH::Vec3& min, const TriangleBVH::Vec3& max, const float tMax)
+    {
+        float tNear = 0.f;
+        float tFar = tMax;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            float t1 = (min[i] - origin[i]) * inverseDirection[i];
+            float t2 = (max[i] - origin[i]) * inverseDirection[i];
+            if (t1 > t2)
+            {
+                std::swap(t1, t2);
+            }
+            tNear = std::max(tNear, t1);
+            tFar = std::min(tFar, t2);
+            if (tNear > tFar)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Möller-Trumbore ray-triangle intersection
+    bool intersectTriangle(const TriangleBVH::Vec3& origin, const TriangleBVH::Vec3& direction,
+                           const TriangleBVH::Vec3& a, const TriangleBVH::Vec3& b, const TriangleBVH::Vec3& c, float& t)
+    {
+        const TriangleBVH::Vec3 edge1 = b - a;
+        const TriangleBVH::Vec3 edge2 = c - a;
+        const TriangleBVH::Vec3 p = sofa::type::cross(direction, edge2);
+        const float determinant = edge1 * p;
+        if (determinant == 0.f)
+        {
+            return false;
+        }
+        const float inverseDeterminant = 1.f / determinant;
+
+        const TriangleBVH::Vec3 s = origin - a;
+        const float u = (s * p) * inverseDeterminant;
+        if (u < 0.f || u > 1.f)
+        {
+            return false;
+        }
+
+        const TriangleBVH::Vec3 q = sofa::type::cross(s, edge1);
+        const float v = (direction * q) * inverseDeterminant;
+        if (v < 0.f || u + v > 1.f)
+        {
+            return false;
+        }
+
+        const float hit = (edge2 * q) * inverseDeterminant;
+        if (hit > 0.f && hit < t)
+        {
+            t = hit;
+            return true;
+        }
+        return false;
+    }
+}
+
+void TriangleBVH::build(std::vector<Vec3> positions, std::vector<Triangle> triangles)
+{
+    m_positions = std::move(positions);
+    m_triangles = std::move(triangles);
+
+    // triangles referring to missing vertices are ignored
+    const auto nbVertices = m_positions.size();
+    m_triangles.erase(std::remove_if(m_triangles.begin(), m_triangles.end(), [nbVertices](const Triangle& triangle)
+    {
+        return triangle[0] >= nbVertices || triangle[1] >= nbVertices || triangle[2] >= nbVertices;
+    }), m_triangles.end());
+
+    m_order.resize(m_triangles.size());
+    std::iota(m_order.begin(), m_order.end(), 0u);
+
+    m_nodes.clear();
+    if (!m_triangles.empty())
+    {
+        m_nodes.reserve(2 * m_triangles.size() / maxLeafSize + 1);
+        buildNode(0, static_cast<unsigned int>(m_triangles.size()));
+    }
+}
+
+void TriangleBVH::refit(std::vector<Vec3> positions)
+{
+    if (positions.size() != m_positions.size())
+    {
+        build(std::move(positions), std::move(m_triangles));
+        return;
+    }
+
+    m_positions = std::move(positions);
+
+    // children are stored after their parent
+    for (auto i = m_nodes.size(); i-- > 0;)
+    {
+        computeBounds(static_cast<unsigned int>(i));
+    }
+}
+
+unsigned int TriangleBVH::buildNode(const unsigned int first, const unsigned int count)
+{
+    const auto nodeIndex = static_cast<unsigned int>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    if (count <= maxLeafSize)
+    {
+        m_nodes[nodeIndex].first = first;
+        m_nodes[nodeIndex].count = count;
+        computeBounds(nodeIndex);
+        return nodeIndex;
+    }
+
+    // the sum of the vertices is used as centroid: only the order matters
+    const auto centroid = [this](const unsigned int triangleIndex)
+    {
+        const auto& triangle = m_triangles[triangleIndex];
+        return m_positions[triangle[0]] + m_positions[triangle[1]] + m_positions[triangle[2]];
+    };
+
+    Vec3 centroidMin(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    Vec3 centroidMax(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+    for (unsigned int i = first; i < first + count; ++i)
+    {
+        const auto c = centroid(m_order[i]);
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            centroidMin[j] = std::min(centroidMin[j], c[j]);
+            centroidMax[j] = std::max(centroidMax[j], c[j]);
+        }
+    }
+
+    // median split along the largest extent
+    const Vec3 extent = centroidMax - centroidMin;
+    const unsigned int axis = extent[0] > extent[1] ? (extent[0] > extent[2] ? 0 : 2) : (extent[1] > extent[2] ? 1 : 2);
+    const unsigned int middle = first + count / 2;
+    std::nth_element(m_order.begin() + first, m_order.begin() + middle, m_order.begin() + first + count,
+        [&centroid, axis](const unsigned int a, const unsigned int b)
+        {
+            return centroid(a)[axis] < centroid(b)[axis];
+        });
+
+    buildNode(first, middle - first);
+    const auto rightChild = buildNode(middle, first + count - middle);
+
+    m_nodes[nodeIndex].first = rightChild;
+    m_nodes[nodeIndex].count = 0;
+    computeBounds(nodeIndex);
+    return nodeIndex;
+}
+
+void TriangleBVH::computeBounds(const unsigned int nodeIndex)
+{
+    auto& node = m_nodes[nodeIndex];
+    if (node.count == 0)
+    {
+        const auto& left = m_nodes[nodeIndex + 1];
+        const auto& right = m_nodes[node.first];
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            node.min[j] = std::min(left.min[j], right.min[j]);
+            node.max[j] = std::max(left.max[j], right.max[j]);
+        }
+        return;
+    }
+
+    node.min = m_positions[m_triangles[m_order[node.first]][0]];
+    node.max = node.min;
+    for (unsigned int i = node.first; i < node.first + node.count; ++i)
+    {
+        for (const auto vertexIndex : m_triangles[m_order[i]])
+        {
+            const auto& position = m_positions[vertexIndex];
+            for (unsigned int j = 0; j < 3; ++j)
+            {
+                node.min[j] = std::min(node.min[j], position[j]);
+                node.max[j] = std::max(node.max[j], position[j]);
+            }
+        }
+    }
+}
+
+bool TriangleBVH::intersect(const Vec3& origin, const Vec3& direction, float& t) const
+{
+    if (m_nodes.empty())
+    {
+        return false;
+    }
+
+    const Vec3 inverseDirection(1.f / direction[0], 1.f / direction[1], 1.f / direction[2]);
+
+    // a median split bounds the depth, hence the number of pending right children
+    std::array<unsigned int, 64> stack;
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    bool hasHit = false;
+    while (stackSize > 0)
+    {
+        const auto nodeIndex = stack[--stackSize];
+        const auto& node = m_nodes[nodeIndex];
+        if (!intersectBox(origin, inverseDirection, node.min, node.max, t))
+        {
+            continue;
+        }
+
+        if (node.count > 0)
+        {
+            for (unsigned int i = node.first; i < node.first + node.count; ++i)
+            {
+                const auto& triangle = m_triangles[m_order[i]];
+                hasHit |= intersectTriangle(origin, direction,
+                    m_positions[triangle[0]], m_positions[triangle[1]], m_positions[triangle[2]], t);
+            }
+        }
+        else
+        {
+            stack[stackSize++] = node.first;
+            stack[stackSize++] = nodeIndex + 1;
+        }
+    }
+    return hasHit;
+}
+
+HoverPicker::HoverPicker() = default;
+
+HoverPicker::~HoverPicker()
+{
+    clear();
+    if (m_worker.joinable())
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_isStopping = true;
+        }
+        m_condition.notify_one();
+        m_worker.join();
+    }
+}
+
+void HoverPicker::requestPick(sofa::simulation::Node* root, const sofa::type::Vec3d& origin, const sofa::type::Vec3d& direction)
+{
+    if (root == nullptr)
+    {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastRequestTime < m_minimumInterval)
+    {
+        return;
+    }
+    m_lastRequestTime = now;
+
+    if (!m_worker.joinable())
+    {
+        m_worker = std::thread(&HoverPicker::processRequests, this);
+    }
+
+    updateGeometry(root);
+
+    const auto normalizedDirection = direction.normalized();
+
+    Ray ray;
+    ray.requestId = ++m_lastRequestId;
+    ray.origin = Vec3(static_cast<float>(origin[0]), static_cast<float>(origin[1]), static_cast<float>(origin[2]));
+    ray.direction = Vec3(static_cast<float>(normalizedDirection[0]), static_cast<float>(normalizedDirection[1]), static_cast<float>(normalizedDirection[2]));
+    {
+        std::lock_guard lock(m_mutex);
+        m_pendingRay = ray;
+    }
+    m_condition.notify_one();
+}
+
+void HoverPicker::resetHover()
+{
+    m_ignoredRequestId = m_lastRequestId;
+    m_hoveredModelId = 0;
+
+    std::lock_guard lock(m_mutex);
+    m_pendingRay.reset();
+    m_result.reset();
+}
+
+void HoverPicker::clear()
+{
+    if (m_root == nullptr && m_models.empty())
+    {
+        return;
+    }
+
+    resetHover();
+    if (m_root)
+    {
+        m_graphListener.detach(m_root.get());
+    }
+    m_root = nullptr;
+    m_visualModels.clear();
+    m_models.clear();
+    m_modelIds.clear();
+
+    std::lock_guard lock(m_mutex);
+    m_pendingUpdates.clear();
+    m_isClearRequested = true;
+}
+
+sofa::core::objectmodel::BaseObject* HoverPicker::getHoveredObject()
+{
+    pollResult();
+
+    const auto it = m_models.find(m_hoveredModelId);
+    return it != m_models.end() ? it->second.object.get() : nullptr;
+}
+
+void HoverPicker::updateGeometry(sofa::simulation::Node* root)
+{
+    if (root != m_root.get())
+    {
+        clear();
+        m_root = sofa::simulation::Node::SPtr(root);
+        m_graphListener.attach(root);
+        m_graphListener.isGraphModified = true;
+    }
+
+    if (m_graphListener.isGraphModified)
+    {
+        m_graphListener.isGraphModified = false;
+        sofa::type::vector<sofa::component::visual::VisualModelImpl*> visualModels;
+        root->getTreeObjects<sofa::component::visual::VisualModelImpl>(&visualModels);
+        m_visualModels.clear();
+        for (auto* visualModel : visualModels)
+        {
+            m_visualModels.emplace_back(visualModel);
+        }
+    }
+
+    std::set<unsigned int> visitedModels;
+    for (const auto& model : m_visualModels)
+    {
+        auto* visualModel = model.get();
+        const auto [idIt, isNewModel] = m_modelIds.try_emplace(visualModel, m_nextModelId);
+        if (isNewModel)
+        {
+            m_models[m_nextModelId].object = visualModel;
+            ++m_nextModelId;
+        }
+        const auto modelId = idIt->second;
+        visitedModels.insert(modelId);
+
+        // only the models modified since the last request are copied
+        auto& record = m_models[modelId];
+        const int positionCounter = getDataCounter(visualModel, "position");
+        const int topologyCounter = getDataCounter(visualModel, "triangles") + getDataCounter(visualModel, "quads");
+        if (positionCounter >= 0 && positionCounter == record.positionCounter && topologyCounter == record.topologyCounter)
+        {
+            continue;
+        }
+
+        GeometryUpdate update;
+        const auto& vertices = visualModel->getVertices();
+        update.positions.reserve(vertices.size());
+        for (const auto& vertex : vertices)
+        {
+            update.positions.emplace_back(static_cast<float>(vertex[0]), static_cast<float>(vertex[1]), static_cast<float>(vertex[2]));
+        }
+
+        update.isTopologyChanged = isNewModel || topologyCounter != record.topologyCounter;
+        if (update.isTopologyChanged)
+        {
+            const auto& triangles = visualModel->getTriangles();
+            const auto& quads = visualModel->getQuads();
+            update.triangles.reserve(triangles.size() + 2 * quads.size());
+            for (const auto& triangle : triangles)
+            {
+                update.triangles.push_back({triangle[0], triangle[1], triangle[2]});
+            }
+            for (const auto& quad : quads)
+            {
+                update.triangles.push_back({quad[0], quad[1], quad[2]});
+                update.triangles.push_back({quad[0], quad[2], quad[3]});
+            }
+        }
+
+        record.positionCounter = positionCounter;
+        record.topologyCounter = topologyCounter;
+        pushUpdate(modelId, std::move(update));
+    }
+
+    // models removed from the scene graph
+    for (auto it = m_models.begin(); it != m_models.end();)
+    {
+        if (visitedModels.find(it->first) == visitedModels.end())
+        {
+            GeometryUpdate update;
+            update.isRemoved = true;
+            pushUpdate(it->first, std::move(update));
+
+            if (it->first == m_hoveredModelId)
+            {
+                m_hoveredModelId = 0;
+            }
+            m_modelIds.erase(it->second.object.get());
+            it = m_models.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void HoverPicker::pushUpdate(const unsigned int modelId, GeometryUpdate update)
+{
+    std::lock_guard lock(m_mutex);
+    auto& pendingUpdate = m_pendingUpdates[modelId];
+
+    // a topology change not processed yet must not be lost by a more recent update of the positions
+    if (pendingUpdate.isTopologyChanged && !update.isTopologyChanged && !update.isRemoved)
+    {
+        update.triangles = std::move(pendingUpdate.triangles);
+        update.isTopologyChanged = true;
+    }
+    pendingUpdate = std::move(update);
+}
+
+void HoverPicker::pollResult()
+{
+    std::lock_guard lock(m_mutex);
+    if (m_result && m_result->requestId > m_ignoredRequestId)
+    {
+        m_hoveredModelId = m_result->modelId;
+        m_hoveredBoundingBox = m_result->boundingBox;
+    }
+    m_result.reset();
+}
+
+void HoverPicker::processRequests()
+{
+    while (true)
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this]{ return m_isStopping || m_pendingRay.has_value(); });
+        if (m_isStopping)
+        {
+            return;
+        }
+
+        const Ray ray = *m_pendingRay;
+        m_pendingRay.reset();
+        const bool isClearRequested = m_isClearRequested;
+        m_isClearRequested = false;
+        auto updates = std::move(m_pendingUpdates);
+        m_pendingUpdates.clear();
+        lock.unlock();
+
+        if (isClearRequested)
+        {
+            m_bvhs.clear();
+        }
+        for (auto& [modelId, update] : updates)
+        {
+            if (update.isRemoved)
+            {
+                m_bvhs.erase(modelId);
+            }
+            else if (update.isTopologyChanged)
+            {
+                m_bvhs[modelId].build(std::move(update.positions), std::move(update.triangles));
+            }
+            else
+            {
+                m_bvhs[modelId].refit(std::move(update.positions));
+            }
+        }
+
+        PickResult result;
+        result.requestId = ray.requestId;
+        float closestHit = std::numeric_limits<float>::max();
+        for (const auto& [modelId, bvh] : m_bvhs)
+        {
+            if (bvh.intersect(ray.origin, ray.direction, closestHit))
+            {
+                result.modelId = modelId;
+                const auto& min = bvh.getMin();
+                const auto& max = bvh.getMax();
+                result.boundingBox = sofa::type::BoundingBox(
+                    sofa::type::Vec3(min[0], min[1], min[2]),
+                    sofa::type::Vec3(max[0], max[1], max[2]));
+            }
+        }
+
+        lock.lock();
+        m_result = result;
+    }
+}
+
+} // namespace sofaimgui
@@ -0,0 +1,193 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+
+#include <SofaGLFW/SofaGLFWGraphListener.h>
+
+#include <sofa/simulation/Node.h>
+#include <sofa/type/Vec.h>
+#include <sofa/type/BoundingBox.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace sofa::component::visual
+{
+    class VisualModelImpl;
+}
+
+namespace sofaimgui
+{
+
+/**
+ * Bounding volume hierarchy over a triangle soup, used to intersect rays with a copy of the
+ * geometry of a visual model, independently of the scene graph.
+ */
+class TriangleBVH
+{
+public:
+    using Vec3 = sofa::type::Vec3f;
+    using Triangle = std::array<unsigned int, 3>;
+
+    /// Builds the hierarchy from scratch
+    void build(std::vector<Vec3> positions, std::vector<Triangle> triangles);
+
+    /// Updates the bounding boxes for new vertex positions, keeping the hierarchy. The topology must be unchanged.
+    void refit(std::vector<Vec3> positions);
+
+    /// Returns true if the ray hits a triangle closer than t. In that case, t is set to the ray parameter of the hit.
+    bool intersect(const Vec3& origin, const Vec3& direction, float& t) const;
+
+    bool empty() const { return m_nodes.empty(); }
+    const Vec3& getMin() const { return m_nodes.front().min; }
+    const Vec3& getMax() const { return m_nodes.front().max; }
+
+private:
+    /// Nodes are stored in depth-first order: the left child of an inner node directly follows it
+    struct BVHNode
+    {
+        Vec3 min;
+        Vec3 max;
+        unsigned int first {}; ///< leaf: first index in m_order. Inner node: index of the right child
+        unsigned int count {}; ///< number of triangles in a leaf, 0 for an inner node
+    };
+
+    unsigned int buildNode(unsigned int first, unsigned int count);
+    void computeBounds(unsigned int nodeIndex);
+
+    std::vector<Vec3> m_positions;
+    std::vector<Triangle> m_triangles;
+    std::vector<unsigned int> m_order;
+    std::vector<BVHNode> m_nodes;
+};
+
+/**
+ * Finds the visual model under the mouse cursor.
+ *
+ * The geometry of the visual models is copied on the GUI side and organized in one BVH per model.
+ * Ray queries are throttled and processed by a background thread, so that hovering the viewport
+ * never costs a render pass. The list of the visual models is kept, and the scene graph is traversed
+ * again only after it has been modified (a node or a component added or removed). The copies are
+ * refreshed only for the models whose geometry changed since the last query, and the BVHs are
+ * refitted instead of rebuilt when the topology is unchanged.
+ *
+ * The background thread is started by the first request.
+ */
+class SOFAIMGUI_API HoverPicker
+{
+public:
+    HoverPicker();
+    ~HoverPicker();
+
+    HoverPicker(const HoverPicker&) = delete;
+    HoverPicker& operator=(const HoverPicker&) = delete;
+
+    /// Sends a pick request along a ray, in world coordinates. Ignored if the previous request is too recent.
+    void requestPick(sofa::simulation::Node* root, const sofa::type::Vec3d& origin, const sofa::type::Vec3d& direction);
+
+    /// Forgets the hovered component, e.g. when the cursor leaves the viewport
+    void resetHover();
+
+    /// Removes all the copied geometry, and stops observing the scene graph (e.g. when hover picking is disabled)
+    void clear();
+
+    /// The component under the cursor, according to the last processed request
+    sofa::core::objectmodel::BaseObject* getHoveredObject();
+
+    /// Bounding box of the hovered component, at the time of the pick
+    const sofa::type::BoundingBox& getHoveredBoundingBox() const { return m_hoveredBoundingBox; }
+
+    void setMinimumInterval(std::chrono::milliseconds interval) { m_minimumInterval = interval; }
+
+private:
+    using Vec3 = TriangleBVH::Vec3;
+
+    struct ModelRecord
+    {
+        sofa::core::objectmodel::BaseObject::SPtr object;
+        int positionCounter { -1 };
+        int topologyCounter { -1 };
+    };
+
+    struct GeometryUpdate
+    {
+        std::vector<Vec3> positions;
+        std::vector<TriangleBVH::Triangle> triangles;
+        bool isTopologyChanged { false };
+        bool isRemoved { false };
+    };
+
+    struct Ray
+    {
+        unsigned int requestId {};
+        Vec3 origin;
+        Vec3 direction;
+    };
+
+    struct PickResult
+    {
+        unsigned int requestId {};
+        unsigned int modelId {}; ///< 0 if nothing was hit
+        sofa::type::BoundingBox boundingBox;
+    };
+
+    void updateGeometry(sofa::simulation::Node* root);
+    void pushUpdate(unsigned int modelId, GeometryUpdate update);
+    void pollResult();
+    void processRequests();
+
+    // main thread
+    sofa::simulation::Node::SPtr m_root;
+    sofaglfw::SofaGLFWGraphListener m_graphListener;
+    std::vector<sofa::core::sptr<sofa::component::visual::VisualModelImpl>> m_visualModels;
+    std::map<unsigned int, ModelRecord> m_models;
+    std::map<const sofa::core::objectmodel::BaseObject*, unsigned int> m_modelIds;
+    unsigned int m_nextModelId { 1 };
+    unsigned int m_lastRequestId {};
+    unsigned int m_ignoredRequestId {}; ///< results of requests up to this one are discarded
+    std::chrono::steady_clock::time_point m_lastRequestTime;
+    std::chrono::milliseconds m_minimumInterval { 50 };
+    unsigned int m_hoveredModelId {};
+    sofa::type::BoundingBox m_hoveredBoundingBox;
+
+    // shared with the worker thread, protected by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::map<unsigned int, GeometryUpdate> m_pendingUpdates;
+    std::optional<Ray> m_pendingRay;
+    std::optional<PickResult> m_result;
+    bool m_isClearRequested { false };
+    bool m_isStopping { false };
+
+    // worker thread
+    std::map<unsigned int, TriangleBVH> m_bvhs;
+    std::thread m_worker;
+};
+
+} // namespace sofaimgui
@@ -25,6 +25,7 @@
 #include <ostream>
 #include <unordered_set>
 #include <SofaGLFW/SofaGLFWBaseGUI.h>
+#include <SofaGLFW/SofaGLFWFrameStages.h>
 
 #include <sofa/core/CategoryLibrary.h>
 #include <sofa/helper/logging/LoggingMessageHandler.h>
@@ -55,6 +56,7 @@
 #include <Roboto-Medium.h>
 #include <Style.h>
 #include <SofaImGui/ImGuiDataWidget.h>
+#include <SofaImGui/LogStore.h>
 #include <sofa/helper/Utils.h>
 #include <sofa/simulation/Node.h>
 #include <sofa/component/visual/VisualStyle.h>
@@ -70,6 +72,7 @@
 #include "windows/Performances.h"
 #include "windows/Log.h"
 #include "windows/Profiler.h"
+#include "windows/SamplingProfiler.h"
 #include "windows/SceneGraph.h"
 #include "windows/DisplayFlags.h"
 #include "windows/Plugins.h"
@@ -86,6 +89,7 @@ namespace sofaimgui
 
 ImGuiGUIEngine::ImGuiGUIEngine()
             : winManagerProfiler(helper::system::FileSystem::append(sofaimgui::getConfigurationFolderPath(), std::string("profiler.txt"))),
+              winManagerSamplingProfiler(helper::system::FileSystem::append(sofaimgui::getConfigurationFolderPath(), std::string("samplingprofiler.txt"))),
               winManagerSceneGraph(helper::system::FileSystem::append(sofaimgui::getConfigurationFolderPath(), std::string("scenegraph.txt"))),
               winManagerPerformances(helper::system::FileSystem::append(sofaimgui::getConfigurationFolderPath(), std::string("performances.txt"))),
               winManagerDisplayFlags(helper::system::FileSystem::append(sofaimgui::getConfigurationFolderPath(), std::string("displayflags.txt"))),
@@ -134,6 +138,10 @@ void ImGuiGUIEngine::init()
     // Setup Dear ImGui style
     sofaimgui::setStyle(pv);
 
+    LogStore::getInstance().setMemoryCapacity(static_cast<std::size_t>(
+        ini.GetLongValue("Log", "memoryCapacity", static_cast<long>(LogStore::defaultMemoryCapacity))));
+    LogStore::getInstance().setRateLimit(ini.GetDoubleValue("Log", "rateLimit", 0.));
+
     sofa::helper::system::PluginManager::getInstance().readFromIniFile(
         sofa::gui::common::BaseGUI::getConfigDirectoryPath() + "/loadedPlugins.ini");
 }
@@ -244,6 +252,7 @@ void ImGuiGUIEngine::startFrame(sofaglfw::SofaGLFWBaseGUI* baseGUI)
     static constexpr auto windowNameViewport = ICON_FA_DICE_D6 "  Viewport";
     static constexpr auto windowNamePerformances = ICON_FA_CHART_LINE "  Performances";
     static constexpr auto windowNameProfiler = ICON_FA_HOURGLASS "  Profiler";
+    static constexpr auto windowNameSamplingProfiler = ICON_FA_CROSSHAIRS "  Sampling Profiler";
     static constexpr auto windowNameSceneGraph = ICON_FA_SITEMAP "  Scene Graph";
     static constexpr auto windowNameDisplayFlags = ICON_FA_EYE "  Display Flags";
     static constexpr auto windowNamePlugins = ICON_FA_PLUS_CIRCLE "  Plugins";
@@ -348,6 +357,7 @@ void ImGuiGUIEngine::startFrame(sofaglfw::SofaGLFWBaseGUI* baseGUI)
                 sofa::simulation::node::unload(groot);
                 baseGUI->setSimulationIsRunning(false);
                 sofa::simulation::node::initRoot(baseGUI->getRootNode().get());
+                baseGUI->redraw();
                 return;
             }
             ImGui::Separator();
@@ -430,14 +440,26 @@ void ImGuiGUIEngine::startFrame(sofaglfw::SofaGLFWBaseGUI* baseGUI)
                 if (result == NFD_OKAY)
                 {
                     helper::io::STBImage image;
-                    image.init(m_currentFBOSize.first, m_currentFBOSize.second, 1, 1, sofa::helper::io::Image::DataType::UINT32, sofa::helper::io::Image::ChannelFormat::RGBA);
+                    if (m_isRenderingDirectly)
+                    {
+                        // ImGui has not been rendered yet: the backbuffer only contains the scene
+                        const auto& sceneViewport = sofa::core::visual::VisualParams::defaultInstance()->viewport();
+                        image.init(sceneViewport[2], sceneViewport[3], 1, 1, sofa::helper::io::Image::DataType::UINT32, sofa::helper::io::Image::ChannelFormat::RGBA);
+
+                        glReadBuffer(GL_BACK);
+                        glReadPixels(sceneViewport[0], sceneViewport[1], sceneViewport[2], sceneViewport[3], GL_RGBA, GL_UNSIGNED_BYTE, image.getPixels());
+                    }
+                    else
+                    {
+                        image.init(m_currentFBOSize.first, m_currentFBOSize.second, 1, 1, sofa::helper::io::Image::DataType::UINT32, sofa::helper::io::Image::ChannelFormat::RGBA);
 
-                    glBindTexture(GL_TEXTURE_2D, m_fbo->getColorTexture());
+                        glBindTexture(GL_TEXTURE_2D, m_fbo->getColorTexture());
 
-                    // Read the pixel data from the OpenGL texture
-                    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getPixels());
+                        // Read the pixel data from the OpenGL texture
+                        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getPixels());
 
-                    glBindTexture(GL_TEXTURE_2D, 0);
+                        glBindTexture(GL_TEXTURE_2D, 0);
+                    }
 
                     image.save(outPath, 90);
                 }
@@ -456,6 +478,8 @@ void ImGuiGUIEngine::startFrame(sofaglfw::SofaGLFWBaseGUI* baseGUI)
 
             ImGui::Checkbox(windowNameProfiler, winManagerProfiler.getStatePtr());
 
+            ImGui::Checkbox(windowNameSamplingProfiler, winManagerSamplingProfiler.getStatePtr());
+
             ImGui::Checkbox(windowNameSceneGraph, winManagerSceneGraph.getStatePtr());
 
             ImGui::Checkbox(windowNameDisplayFlags, winManagerDisplayFlags.getStatePtr());
@@ -533,9 +557,16 @@ void ImGuiGUIEngine::startFrame(sofaglfw::SofaGLFWBaseGUI* baseGUI)
     /***************************************
      * Viewport window
      **************************************/
-    showViewPort(groot, windowNameViewport, ini, m_fbo, m_viewportWindowSize,
+    const bool isHoverPickingEnabled = ini.GetBoolValue("Visualization", "hoverPicking", false);
+    if (!isHoverPickingEnabled)
+    {
+        m_hoverPicker.clear();
+    }
+    showViewPort(groot, windowNameViewport, ini, m_fbo, m_isRenderingDirectly,
+                 m_viewportWindowSize, m_viewportWindowPosition,
                  isMouseOnViewport, winManagerViewPort, baseGUI,
-                 isViewportDisplayedForTheFirstTime, lastViewPortPos);
+                 isViewportDisplayedForTheFirstTime, lastViewPortPos,
+                 isHoverPickingEnabled ? &m_hoverPicker : nullptr);
 
 
     /***************************************
@@ -547,17 +578,34 @@ void ImGuiGUIEngine::startFrame(sofaglfw::SofaGLFWBaseGUI* baseGUI)
     /***************************************
      * Profiler window
      **************************************/
-    sofa::helper::AdvancedTimer::setEnabled("Animate", winManagerProfiler.getStatePtr());
-    sofa::helper::AdvancedTimer::setInterval("Animate", 1);
-    sofa::helper::AdvancedTimer::setOutputType("Animate", "gui");
+    // nobody looks at the records while the Profiler and the costs of the scene graph are closed: the timer is disabled,
+    // unless a trace or profiling file is written from the same records
+    const bool areComponentCostsShown = m_componentCosts.isEnabled() && *winManagerSceneGraph.getStatePtr();
+    m_profilingState.setTimerRequired(baseGUI->areStepRecordsRequired());
+    m_profilingState.setSuspended(!*winManagerProfiler.getStatePtr() && !areComponentCostsShown);
+
+    windows::showProfiler(groot, windowNameProfiler, winManagerProfiler, m_profilingState);
+    if (groot->animate_.getValue())
+    {
+        if (areComponentCostsShown && m_profilingState.isRecording())
+        {
+            m_componentCosts.addStep(sofa::helper::AdvancedTimer::getRecords("Animate"));
+        }
+        m_profilingState.prepareNextStep();
+    }
+
+    /***************************************
+     * Sampling profiler window
+     **************************************/
+    windows::showSamplingProfiler(windowNameSamplingProfiler, winManagerSamplingProfiler, m_samplingProfiler);
 
-    windows::showProfiler(groot, windowNameProfiler, winManagerProfiler);
     /***************************************
      * Scene graph window
      **************************************/
     static std::set<core::objectmodel::BaseObject*> openedComponents;
     static std::set<core::objectmodel::BaseObject*> focusedComponents;
-    windows::showSceneGraph(groot, windowNameSceneGraph, openedComponents, focusedComponents, winManagerSceneGraph);
+    windows::showSceneGraph(groot, windowNameSceneGraph, openedComponents, focusedComponents, winManagerSceneGraph,
+                            isHoverPickingEnabled ? m_hoverPicker.getHoveredObject() : nullptr, &m_componentCosts);
 
 
     /***************************************
@@ -585,6 +633,13 @@ void ImGuiGUIEngine::startFrame(sofaglfw::SofaGLFWBaseGUI* baseGUI)
      **************************************/
     windows::showSettings(windowNameSettings,ini, winManagerSettings);
 
+    // an edition in the UI (data widgets, menus, settings...) may have modified the scene
+    if (ImGui::GetCurrentContext()->ActiveIdHasBeenEditedThisFrame)
+    {
+        baseGUI->redraw();
+    }
+
+    sofaglfw::SofaGLFWFrameStages::ScopedStage renderStage(sofaglfw::SofaGLFWFrameStages::Stage::UIRender);
     ImGui::Render();
 #if SOFAIMGUI_FORCE_OPENGL2 == 1
     ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
@@ -620,11 +675,43 @@ void ImGuiGUIEngine::resetView(ImGuiID dockspace_id, const char* windowNameScene
     firstRunState.setState(true);// Mark first run as complete
 }
 
-void ImGuiGUIEngine::beforeDraw(GLFWwindow*)
+void ImGuiGUIEngine::beforeDraw(GLFWwindow* window)
 {
     glClearColor(0,0,0,1);
     glClear(GL_COLOR_BUFFER_BIT);
 
+    m_isRenderingDirectly = ini.GetBoolValue("Visualization", "renderViewportDirectly", false);
+    m_isLastSceneImageAvailable = false;
+
+    if (m_isRenderingDirectly)
+    {
+        // the scene is drawn straight into the area of the viewport window: the FBO is useless
+        if (m_fbo)
+        {
+            m_fbo.reset();
+            m_currentFBOSize = {0, 0};
+        }
+
+        int framebufferWidth, framebufferHeight;
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+
+        // the viewport window position is expressed in ImGui coordinates (origin at the top left corner of the screen)
+        // whereas OpenGL expects framebuffer coordinates (origin at the bottom left corner of the window)
+        const ImVec2 scale = ImGui::GetIO().DisplayFramebufferScale;
+        const ImVec2 mainViewportPos = ImGui::GetMainViewport()->Pos;
+        const int width = std::max(1, static_cast<int>(m_viewportWindowSize.first * scale.x));
+        const int height = std::max(1, static_cast<int>(m_viewportWindowSize.second * scale.y));
+        const int x = static_cast<int>((m_viewportWindowPosition.first - mainViewportPos.x) * scale.x);
+        const int y = framebufferHeight - static_cast<int>((m_viewportWindowPosition.second - mainViewportPos.y) * scale.y) - height;
+
+        sofa::core::visual::VisualParams::defaultInstance()->viewport() = {x, y, width, height};
+
+        // restrict the clear of the scene background to the viewport area
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(x, y, width, height);
+        return;
+    }
+
     if (!m_fbo)
     {
         m_fbo = std::make_unique<sofa::gl::FrameBufferObject>();
@@ -639,6 +726,10 @@ void ImGuiGUIEngine::beforeDraw(GLFWwindow*)
             m_fbo->setSize(static_cast<unsigned int>(m_viewportWindowSize.first), static_cast<unsigned int>(m_viewportWindowSize.second));
             m_currentFBOSize = {static_cast<unsigned int>(m_viewportWindowSize.first), static_cast<unsigned int>(m_viewportWindowSize.second)};
         }
+        else
+        {
+            m_isLastSceneImageAvailable = true;
+        }
     }
     sofa::core::visual::VisualParams::defaultInstance()->viewport() = {0,0,m_currentFBOSize.first, m_currentFBOSize.second};
 
@@ -647,11 +738,19 @@ void ImGuiGUIEngine::beforeDraw(GLFWwindow*)
 
 void ImGuiGUIEngine::afterDraw()
 {
-    m_fbo->stop();
+    if (m_isRenderingDirectly)
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+    else
+    {
+        m_fbo->stop();
+    }
 }
 
 void ImGuiGUIEngine::terminate()
 {
+    m_samplingProfiler.stop();
     NFD_Quit();
 
 #if SOFAIMGUI_FORCE_OPENGL2 == 1
@@ -29,6 +29,10 @@
 #include <imgui.h>
 #include <sofa/simulation/Node.h>
 #include <SimpleIni.h>
+#include <SofaImGui/HoverPicker.h>
+#include <SofaImGui/ProfilingState.h>
+#include <SofaImGui/ComponentCosts.h>
+#include <SofaImGui/SamplingProfiler.h>
 #include "windows/WindowState.h"
 
 using windows::WindowState;
@@ -57,18 +61,33 @@ public:
     void afterDraw() override;
     void terminate() override;
     bool dispatchMouseEvents() override;
+    bool canReuseLastSceneImage() const override { return m_isLastSceneImageAvailable; }
 
 protected:
     std::unique_ptr<sofa::gl::FrameBufferObject> m_fbo;
     std::pair<unsigned int, unsigned int> m_currentFBOSize;
     std::pair<float, float> m_viewportWindowSize;
+    std::pair<float, float> m_viewportWindowPosition;
+    /// true if the scene is rendered directly in the backbuffer, in the area of the viewport window (no intermediate FBO)
+    bool m_isRenderingDirectly { false };
+    /// true if the FBO still contains the scene drawn during a previous frame (i.e. it has not been created or resized since)
+    bool m_isLastSceneImageAvailable { false };
     bool isMouseOnViewport { false };
+    /// finds the component under the cursor, when hover picking is enabled
+    HoverPicker m_hoverPicker;
+    /// recording of the timers displayed in the Profiler
+    ProfilingState m_profilingState;
+    /// cost of the components displayed in the scene graph
+    ComponentCosts m_componentCosts;
+    /// statistical profiler of the main thread, displayed in the Sampling Profiler
+    SamplingProfiler m_samplingProfiler;
     CSimpleIniA ini;
     void loadFile(sofaglfw::SofaGLFWBaseGUI* baseGUI, sofa::core::sptr<sofa::simulation::Node>& groot, std::string filePathName);
     void resetView(ImGuiID dockspace_id, const char *windowNameSceneGraph, const char *windowNameLog, const char *windowNameViewport) ;
 
     // WindowState members
     windows::WindowState winManagerProfiler;
+    windows::WindowState winManagerSamplingProfiler;
     windows::WindowState winManagerSceneGraph;
     windows::WindowState winManagerPerformances;
     windows::WindowState winManagerDisplayFlags;
@@ -0,0 +1,366 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/LogCache.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace sofaimgui
+{
+
+namespace
+{
+    /// Merges sorted lists of indices
+    std::vector<LogCache::RowIndex> mergeIndices(const std::vector<const std::vector<LogCache::RowIndex>*>& lists)
+    {
+        std::size_t size = 0;
+        for (const auto* list : lists)
+        {
+            size += list->size();
+        }
+        std::vector<LogCache::RowIndex> merged;
+        merged.reserve(size);
+
+        if (lists.size() == 1)
+        {
+            merged = *lists.front();
+            return merged;
+        }
+
+        // position in each list, in a min-heap ordered by the next index of the list
+        using Cursor = std::pair<LogCache::RowIndex, std::size_t>; // next index, list
+        std::vector<std::size_t> positions(lists.size(), 0);
+        std::priority_queue<Cursor, std::vector<Cursor>, std::greater<>> heap;
+        for (std::size_t i = 0; i < lists.size(); ++i)
+        {
+            if (!lists[i]->empty())
+            {
+                heap.emplace(lists[i]->front(), i);
+            }
+        }
+        while (!heap.empty())
+        {
+            const auto [index, list] = heap.top();
+            heap.pop();
+            merged.push_back(index);
+            if (++positions[list] < lists[list]->size())
+            {
+                heap.emplace((*lists[list])[positions[list]], list);
+            }
+        }
+        return merged;
+    }
+}
+
+LogCache::LogCache()
+{
+    m_isTypeShown.fill(true);
+}
+
+bool LogCache::update(const LogStore& store, const std::function<void(std::size_t, const LogStore::Entry&)>& onNewMessage)
+{
+    const std::size_t nbMessages = store.getNbMessages();
+    if (store.getNbResets() != m_nbStoreResets || nbMessages < m_rows.size())
+    {
+        // the log has been cleared
+        m_nbStoreResets = store.getNbResets();
+        ++m_nbResets;
+        clearRows();
+    }
+    if (nbMessages == m_rows.size())
+    {
+        return false;
+    }
+
+    LogStore::Entry entry;
+    for (std::size_t i = m_rows.size(); i < nbMessages && store.getEntry(i, entry); ++i)
+    {
+        const auto index = static_cast<RowIndex>(i);
+
+        Row row;
+        row.type = static_cast<std::uint8_t>(entry.type);
+        row.sourceId = getSourceId(entry.componentPath.empty() ? entry.sender : entry.componentPath);
+        const auto nbLines = 1 + std::count(entry.text.begin(), entry.text.end(), '\n');
+        row.nbLines = static_cast<std::uint16_t>(std::min<std::ptrdiff_t>(nbLines, std::numeric_limits<std::uint16_t>::max()));
+        row.textWidth = ImGui::CalcTextSize(entry.text.c_str(), entry.text.c_str() + entry.text.size()).x;
+        row.textHash = static_cast<std::uint64_t>(std::hash<std::string>{}(entry.text));
+
+        if (row.type < nbTypes)
+        {
+            m_typeRows[row.type].push_back(index);
+        }
+        m_sources[row.sourceId].rows.push_back(index);
+
+        m_rows.push_back(row);
+        // in collapsed mode, a repeated message only updates its group
+        const bool isNewRow = !m_isCollapsed || addToGroup(index);
+        if (isNewRow && isVisible(row))
+        {
+            m_visibleRows.push_back(index);
+            m_heights.push_back(estimateHeight(row));
+        }
+
+        if (onNewMessage)
+        {
+            onNewMessage(i, entry);
+        }
+    }
+    return true;
+}
+
+void LogCache::clearRows()
+{
+    m_rows.clear();
+    m_visibleRows.clear();
+    m_heights.clear();
+    for (auto& rows : m_typeRows)
+    {
+        rows.clear();
+    }
+    for (auto& source : m_sources)
+    {
+        source.rows.clear();
+    }
+    m_groups.clear();
+    m_groupIds.clear();
+}
+
+void LogCache::setTypeShown(const Message::Type type, const bool isShown)
+{
+    auto& isTypeShown = m_isTypeShown[static_cast<std::size_t>(type)];
+    if (isShown != isTypeShown)
+    {
+        isTypeShown = isShown;
+        filterRows();
+    }
+}
+
+void LogCache::setSourceSelected(const std::size_t sourceId, const bool isSelected)
+{
+    if (sourceId >= m_sources.size() || m_isSourceSelected[sourceId] == isSelected)
+    {
+        return;
+    }
+    m_isSourceSelected[sourceId] = isSelected;
+    if (isSelected)
+    {
+        ++m_nbSelectedSources;
+    }
+    else
+    {
+        --m_nbSelectedSources;
+    }
+    filterRows();
+}
+
+void LogCache::clearSourceSelection()
+{
+    if (m_nbSelectedSources > 0)
+    {
+        m_isSourceSelected.assign(m_sources.size(), false);
+        m_nbSelectedSources = 0;
+        filterRows();
+    }
+}
+
+void LogCache::setCollapsed(const bool isCollapsed)
+{
+    if (isCollapsed == m_isCollapsed)
+    {
+        return;
+    }
+    m_isCollapsed = isCollapsed;
+
+    m_groups.clear();
+    m_groupIds.clear();
+    if (m_isCollapsed)
+    {
+        for (std::size_t i = 0; i < m_rows.size(); ++i)
+        {
+            addToGroup(static_cast<RowIndex>(i));
+        }
+    }
+    else
+    {
+        // release the memory of the groups
+        std::vector<Group>().swap(m_groups);
+        decltype(m_groupIds)().swap(m_groupIds);
+    }
+    filterRows();
+}
+
+const LogCache::Group* LogCache::findGroup(const std::size_t index) const
+{
+    if (!m_isCollapsed || index >= m_rows.size())
+    {
+        return nullptr;
+    }
+    const auto it = m_groupIds.find(getGroupKey(m_rows[index]));
+    return it != m_groupIds.end() ? &m_groups[it->second] : nullptr;
+}
+
+bool LogCache::addToGroup(const RowIndex index)
+{
+    const auto [it, isInserted] = m_groupIds.try_emplace(getGroupKey(m_rows[index]), static_cast<std::uint32_t>(m_groups.size()));
+    if (isInserted)
+    {
+        m_groups.push_back({index, index, 1});
+        return true;
+    }
+    auto& group = m_groups[it->second];
+    group.last = index;
+    ++group.count;
+    return false;
+}
+
+std::uint32_t LogCache::getSourceId(const std::string& name)
+{
+    const auto [it, isInserted] = m_sourceIds.try_emplace(name, static_cast<std::uint32_t>(m_sources.size()));
+    if (isInserted)
+    {
+        m_sources.push_back({name, {}});
+        m_isSourceSelected.push_back(false);
+    }
+    return it->second;
+}
+
+std::size_t LogCache::findVisibleIndex(const std::size_t index) const
+{
+    const auto it = std::lower_bound(m_visibleRows.begin(), m_visibleRows.end(), index,
+                                     [](const RowIndex row, const std::size_t i) { return row < i; });
+    return it != m_visibleRows.end() && *it == index ? static_cast<std::size_t>(it - m_visibleRows.begin()) : m_visibleRows.size();
+}
+
+void LogCache::setLayout(const float wrapWidth, const float lineHeight, const float rowPadding)
+{
+    if (wrapWidth == m_wrapWidth && lineHeight == m_lineHeight && rowPadding == m_rowPadding)
+    {
+        return;
+    }
+    m_wrapWidth = wrapWidth;
+    m_lineHeight = lineHeight;
+    m_rowPadding = rowPadding;
+
+    std::vector<double> heights(m_visibleRows.size());
+    for (std::size_t i = 0; i < m_visibleRows.size(); ++i)
+    {
+        heights[i] = estimateHeight(m_rows[m_visibleRows[i]]);
+    }
+    m_heights.assign(std::move(heights));
+}
+
+float LogCache::measureRowHeight(const std::size_t visibleIndex, const std::string& text)
+{
+    const float textHeight = ImGui::CalcTextSize(text.c_str(), text.c_str() + text.size(), false, m_wrapWidth).y;
+    const double height = static_cast<double>(std::max(textHeight, m_lineHeight) + m_rowPadding);
+    if (height != m_heights[visibleIndex])
+    {
+        m_heights.set(visibleIndex, height);
+    }
+    return static_cast<float>(height);
+}
+
+bool LogCache::isVisible(const Row& row) const
+{
+    return (row.type >= nbTypes || m_isTypeShown[row.type])
+        && (m_nbSelectedSources == 0 || m_isSourceSelected[row.sourceId]);
+}
+
+double LogCache::estimateHeight(const Row& row) const
+{
+    // as many lines as the explicit line breaks, or as needed to wrap the whole text
+    float nbLines = static_cast<float>(row.nbLines);
+    if (m_wrapWidth > 0.f)
+    {
+        nbLines = std::max(nbLines, std::ceil(row.textWidth / m_wrapWidth));
+    }
+    return static_cast<double>(nbLines * m_lineHeight + m_rowPadding);
+}
+
+void LogCache::filterRows()
+{
+    ++m_filterRevision;
+    if (m_isCollapsed)
+    {
+        // the first rows of the visible groups, in order
+        m_visibleRows.clear();
+        std::vector<double> heights;
+        for (const auto& group : m_groups)
+        {
+            if (isVisible(m_rows[group.first]))
+            {
+                m_visibleRows.push_back(group.first);
+                heights.push_back(estimateHeight(m_rows[group.first]));
+            }
+        }
+        m_heights.assign(std::move(heights));
+        return;
+    }
+
+    // the smallest set of indices containing the visible rows: the rows of the selected sources, or of the shown types
+    std::vector<const std::vector<RowIndex>*> lists;
+    if (m_nbSelectedSources > 0)
+    {
+        for (std::size_t i = 0; i < m_sources.size(); ++i)
+        {
+            if (m_isSourceSelected[i])
+            {
+                lists.push_back(&m_sources[i].rows);
+            }
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < nbTypes; ++i)
+        {
+            if (m_isTypeShown[i])
+            {
+                lists.push_back(&m_typeRows[i]);
+            }
+        }
+    }
+
+    m_visibleRows.clear();
+    std::vector<double> heights;
+    if (!lists.empty())
+    {
+        m_visibleRows = mergeIndices(lists);
+        if (m_nbSelectedSources > 0)
+        {
+            m_visibleRows.erase(std::remove_if(m_visibleRows.begin(), m_visibleRows.end(),
+                [this](const RowIndex i) { return !isVisible(m_rows[i]); }), m_visibleRows.end());
+        }
+        heights.reserve(m_visibleRows.size());
+        for (const auto i : m_visibleRows)
+        {
+            heights.push_back(estimateHeight(m_rows[i]));
+        }
+    }
+    m_heights.assign(std::move(heights));
+}
+
+} // namespace sofaimgui
@@ -0,0 +1,198 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+
+#include <SofaImGui/LogStore.h>
+#include <SofaImGui/PrefixSumTree.h>
+#include <sofa/helper/logging/Message.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sofaimgui
+{
+
+/**
+ * Rows of the Log window: what is needed to lay out and filter the messages of the LogStore, computed
+ * once when they are added, and the heights of the rows once their message is wrapped in the message
+ * column. The content of the messages stays in the store: it is read only for the rows displayed, so
+ * that a row takes a few bytes of memory, whatever the size of its message.
+ *
+ * The heights of all the rows are estimated from the width of their text, and replaced by the exact
+ * height when a row is displayed. Their prefix sums give the rows visible at a scrolling position, so
+ * that only these rows are displayed, whatever the size of the log.
+ *
+ * The rows can be filtered by type and by source (the component, or the sender of the messages not
+ * sent by a component). The rows of each type and of each source are indexed as they are added: the
+ * number of messages of a type is known without counting, and a change of filter merges the indices
+ * of the selected types or sources instead of testing all the rows.
+ *
+ * In collapsed mode, the identical messages (same source, type and text) are grouped, and only the
+ * first row of each group is visible. The groups are built from a hash of the texts, without reading
+ * the messages again, when the mode is enabled, and released when it is disabled.
+ */
+class SOFAIMGUI_API LogCache
+{
+public:
+    using Message = sofa::helper::logging::Message;
+    /// Index of a row, which is also the index of its message in the store
+    using RowIndex = std::uint32_t;
+
+    LogCache();
+
+    static constexpr std::size_t nbTypes = static_cast<std::size_t>(Message::TypeCount);
+
+    struct Row
+    {
+        std::uint64_t textHash {};
+        float textWidth {};           ///< width of the text without wrapping, all the lines put end to end
+        std::uint32_t sourceId {};
+        std::uint16_t nbLines { 1 };
+        std::uint8_t type { Message::Info };
+
+        Message::Type getType() const { return static_cast<Message::Type>(type); }
+    };
+
+    /// Adds the rows of the messages received by the store since the previous update, and calls
+    /// onNewMessage with the index and the content of each of them. Returns true if rows have been added.
+    /// Everything is added again if the store has been cleared.
+    bool update(const LogStore& store, const std::function<void(std::size_t, const LogStore::Entry&)>& onNewMessage = {});
+
+    struct Source
+    {
+        std::string name;           ///< path of the component, or sender
+        std::vector<RowIndex> rows; ///< indices of the rows of the source, in the order of the log
+    };
+
+    /// Number of messages of a type in the log
+    std::size_t getNbMessages(Message::Type type) const { return m_typeRows[static_cast<std::size_t>(type)].size(); }
+
+    void setTypeShown(Message::Type type, bool isShown);
+    bool isTypeShown(Message::Type type) const { return m_isTypeShown[static_cast<std::size_t>(type)]; }
+
+    const std::vector<Source>& getSources() const { return m_sources; }
+    /// When some sources are selected, only their rows are shown. All the sources are shown otherwise.
+    void setSourceSelected(std::size_t sourceId, bool isSelected);
+    bool isSourceSelected(std::size_t sourceId) const { return m_isSourceSelected[sourceId]; }
+    std::size_t getNbSelectedSources() const { return m_nbSelectedSources; }
+    void clearSourceSelection();
+
+    /// Identical messages, shown as a single row in collapsed mode
+    struct Group
+    {
+        RowIndex first {};
+        RowIndex last {};
+        std::uint32_t count {};
+    };
+
+    void setCollapsed(bool isCollapsed);
+    bool isCollapsed() const { return m_isCollapsed; }
+    /// Group of a row in collapsed mode, nullptr otherwise
+    const Group* findGroup(std::size_t index) const;
+
+    /// Sets the width of the message column, in which the text is wrapped, and the height of a line of
+    /// text and the vertical padding of the rows. The heights are estimated again if they changed.
+    void setLayout(float wrapWidth, float lineHeight, float rowPadding);
+
+    std::size_t getNbMessages() const { return m_rows.size(); }
+    const Row& getRow(std::size_t index) const { return m_rows[index]; }
+    /// Number of times the log has been cleared, to know that the rows have been replaced
+    std::size_t getNbResets() const { return m_nbResets; }
+
+    /// The visible rows are the rows not filtered out
+    std::size_t getNbVisibleRows() const { return m_visibleRows.size(); }
+    /// Index of the row, and of its message, at a position among the visible rows
+    std::size_t getVisibleRowIndex(std::size_t visibleIndex) const { return m_visibleRows[visibleIndex]; }
+    const Row& getVisibleRow(std::size_t visibleIndex) const { return m_rows[m_visibleRows[visibleIndex]]; }
+    /// Position of a row among the visible rows, or getNbVisibleRows() if it is filtered out
+    std::size_t findVisibleIndex(std::size_t index) const;
+    /// Changes each time the filter changes, i.e. when the visible indices of the rows change
+    std::size_t getFilterRevision() const { return m_filterRevision; }
+
+    /// Vertical position of a visible row, from the top of the first one
+    float getRowTop(std::size_t visibleIndex) const { return static_cast<float>(m_heights.prefixSum(visibleIndex)); }
+    float getTotalHeight() const { return static_cast<float>(m_heights.total()); }
+    /// Index of the visible row at a vertical position
+    std::size_t findVisibleRow(float y) const { return m_heights.find(static_cast<double>(y)); }
+
+    /// Computes the exact height of a visible row from the text of its message, which replaces its estimation
+    float measureRowHeight(std::size_t visibleIndex, const std::string& text);
+
+private:
+    std::uint32_t getSourceId(const std::string& name);
+    bool isVisible(const Row& row) const;
+    double estimateHeight(const Row& row) const;
+    void clearRows();
+    void filterRows();
+    /// Adds a row to its group. Returns true if the row is the first of a new group.
+    bool addToGroup(RowIndex index);
+
+    std::vector<Row> m_rows;
+    std::vector<RowIndex> m_visibleRows; ///< indices in m_rows
+    PrefixSumTree<double> m_heights;     ///< heights of the visible rows
+    std::size_t m_nbResets {};
+    std::size_t m_nbStoreResets {};
+    std::size_t m_filterRevision {};
+
+    std::array<std::vector<RowIndex>, nbTypes> m_typeRows; ///< indices of the rows of each type
+    std::array<bool, nbTypes> m_isTypeShown;
+
+    std::vector<Source> m_sources;
+    std::unordered_map<std::string, std::uint32_t> m_sourceIds;
+    std::vector<bool> m_isSourceSelected;
+    std::size_t m_nbSelectedSources {};
+
+    struct GroupKey
+    {
+        std::uint64_t textHash {};
+        std::uint32_t sourceId {};
+        std::uint8_t type {};
+
+        bool operator==(const GroupKey& other) const
+        {
+            return textHash == other.textHash && sourceId == other.sourceId && type == other.type;
+        }
+    };
+    struct GroupKeyHash
+    {
+        std::size_t operator()(const GroupKey& key) const
+        {
+            return static_cast<std::size_t>(key.textHash ^ (std::uint64_t(key.sourceId) << 8 | key.type) * 0x9E3779B97F4A7C15ull);
+        }
+    };
+    static GroupKey getGroupKey(const Row& row) { return {row.textHash, row.sourceId, row.type}; }
+
+    bool m_isCollapsed { false };
+    std::vector<Group> m_groups; ///< in the order of their first row
+    std::unordered_map<GroupKey, std::uint32_t, GroupKeyHash> m_groupIds;
+
+    float m_wrapWidth { 0.f };
+    float m_lineHeight { 0.f };
+    float m_rowPadding { 0.f };
+};
+
+} // namespace sofaimgui
@@ -0,0 +1,320 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/LogSearchIndex.h>
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+namespace sofaimgui
+{
+
+namespace
+{
+    std::string toLowerCase(const std::string& text)
+    {
+        std::string lowerCase = text;
+        std::transform(lowerCase.begin(), lowerCase.end(), lowerCase.begin(),
+                       [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return lowerCase;
+    }
+
+    /// Distinct trigrams of a text, sorted
+    std::vector<std::uint32_t> getTrigrams(const std::string& text)
+    {
+        std::vector<std::uint32_t> trigrams;
+        if (text.size() < 3)
+        {
+            return trigrams;
+        }
+        trigrams.reserve(text.size() - 2);
+        for (std::size_t i = 0; i + 2 < text.size(); ++i)
+        {
+            trigrams.push_back(static_cast<std::uint32_t>(static_cast<unsigned char>(text[i])) << 16
+                             | static_cast<std::uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8
+                             | static_cast<std::uint32_t>(static_cast<unsigned char>(text[i + 2])));
+        }
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+        return trigrams;
+    }
+}
+
+LogSearchIndex::LogSearchIndex(const LogStore& store)
+    : m_store(store)
+    , m_thread(&LogSearchIndex::indexLoop, this)
+{
+}
+
+LogSearchIndex::~LogSearchIndex()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_condition.notify_one();
+    m_thread.join();
+}
+
+void LogSearchIndex::add(const std::string& text)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_pendingTexts.push_back(text);
+    }
+    m_condition.notify_one();
+}
+
+void LogSearchIndex::clear()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_pendingTexts.clear();
+        m_isClearRequested = true;
+    }
+    m_condition.notify_one();
+}
+
+void LogSearchIndex::search(const std::string& query)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_pendingQuery = query;
+        m_isQueryPending = true;
+    }
+    m_condition.notify_one();
+}
+
+std::size_t LogSearchIndex::getRevision() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_revision;
+}
+
+bool LogSearchIndex::updateHits(std::size_t& searchRevision, std::string& query, std::vector<RowIndex>& hits) const
+{
+    std::lock_guard lock(m_mutex);
+    if (searchRevision != m_searchRevision || hits.size() > m_hits.size())
+    {
+        searchRevision = m_searchRevision;
+        query = m_hitsQuery;
+        hits = m_hits;
+        return true;
+    }
+    hits.insert(hits.end(), m_hits.begin() + static_cast<std::ptrdiff_t>(hits.size()), m_hits.end());
+    return false;
+}
+
+bool LogSearchIndex::isBusy() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_isIndexing || m_isQueryPending || !m_pendingTexts.empty();
+}
+
+void LogSearchIndex::indexLoop()
+{
+    std::vector<std::string> texts;
+    std::vector<RowIndex> newHits;
+    while (true)
+    {
+        bool isClearRequested = false;
+        bool isQueryPending = false;
+        std::string query;
+        {
+            std::unique_lock lock(m_mutex);
+            m_isIndexing = false;
+            m_condition.wait(lock, [this] { return m_isStopping || m_isClearRequested || m_isQueryPending || !m_pendingTexts.empty(); });
+            if (m_isStopping)
+            {
+                return;
+            }
+            m_isIndexing = true;
+            texts.swap(m_pendingTexts);
+            std::swap(isClearRequested, m_isClearRequested);
+            std::swap(isQueryPending, m_isQueryPending);
+            query.swap(m_pendingQuery);
+        }
+
+        if (isClearRequested)
+        {
+            resetIndex();
+        }
+
+        // a new search, or the rows cleared, replaces all the hits. Otherwise only the hits of the new rows are published.
+        const bool isNewSearch = isClearRequested || isQueryPending;
+        newHits.clear();
+        if (isQueryPending)
+        {
+            m_query = toLowerCase(query);
+            findHits(newHits);
+        }
+
+        for (const auto& text : texts)
+        {
+            indexRow(text, newHits);
+        }
+        texts.clear();
+
+        if (isNewSearch || !newHits.empty())
+        {
+            std::lock_guard lock(m_mutex);
+            if (isQueryPending)
+            {
+                m_hitsQuery = query;
+            }
+            if (isNewSearch)
+            {
+                m_hits.swap(newHits);
+                ++m_searchRevision;
+            }
+            else
+            {
+                m_hits.insert(m_hits.end(), newHits.begin(), newHits.end());
+            }
+            ++m_revision;
+        }
+    }
+}
+
+void LogSearchIndex::indexRow(const std::string& text, std::vector<RowIndex>& newHits)
+{
+    const auto row = static_cast<RowIndex>(m_nbRows++);
+
+    // the logs repeat the same messages: a text is only indexed the first time it appears
+    const auto hash = static_cast<std::uint64_t>(std::hash<std::string>{}(text));
+    auto it = m_textIds.find(hash);
+    if (it == m_textIds.end())
+    {
+        if (m_textIds.size() >= maxIndexedTexts)
+        {
+            m_unindexedRows.push_back(row);
+            if (!m_query.empty() && toLowerCase(text).find(m_query) != std::string::npos)
+            {
+                newHits.push_back(row);
+            }
+            return;
+        }
+
+        const auto textId = static_cast<std::uint32_t>(m_textRows.size());
+        it = m_textIds.emplace(hash, textId).first;
+        m_textRows.emplace_back();
+        const std::string lowerCase = toLowerCase(text);
+        for (const auto trigram : getTrigrams(lowerCase))
+        {
+            m_trigramTexts[trigram].push_back(textId);
+        }
+        m_isTextHit.push_back(!m_query.empty() && lowerCase.find(m_query) != std::string::npos);
+    }
+
+    const std::uint32_t textId = it->second;
+    m_textRows[textId].push_back(row);
+    if (m_isTextHit[textId])
+    {
+        newHits.push_back(row);
+    }
+}
+
+void LogSearchIndex::findHits(std::vector<RowIndex>& hits)
+{
+    m_isTextHit.assign(m_textRows.size(), false);
+    if (m_query.empty())
+    {
+        return;
+    }
+
+    std::vector<std::uint32_t> candidates;
+    const auto trigrams = getTrigrams(m_query);
+    if (trigrams.empty())
+    {
+        // too short to use the index: all the distinct texts are checked
+        candidates.resize(m_textRows.size());
+        for (std::uint32_t i = 0; i < candidates.size(); ++i)
+        {
+            candidates[i] = i;
+        }
+    }
+    else
+    {
+        // intersection of the texts of the trigrams, starting with the rarest trigram
+        std::vector<const std::vector<std::uint32_t>*> lists;
+        for (const auto trigram : trigrams)
+        {
+            const auto it = m_trigramTexts.find(trigram);
+            if (it == m_trigramTexts.end())
+            {
+                lists.clear();
+                break;
+            }
+            lists.push_back(&it->second);
+        }
+        std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+        if (!lists.empty())
+        {
+            candidates = *lists.front();
+        }
+        std::vector<std::uint32_t> intersection;
+        for (std::size_t i = 1; i < lists.size() && !candidates.empty(); ++i)
+        {
+            intersection.clear();
+            std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(intersection));
+            candidates.swap(intersection);
+        }
+    }
+
+    // the trigrams can be in another order than in the query: the candidates are checked on the text
+    // of their first row, read back from the store
+    LogStore::Entry entry;
+    for (const auto textId : candidates)
+    {
+        if (isHit(m_textRows[textId].front(), entry))
+        {
+            m_isTextHit[textId] = true;
+            hits.insert(hits.end(), m_textRows[textId].begin(), m_textRows[textId].end());
+        }
+    }
+    for (const auto row : m_unindexedRows)
+    {
+        if (isHit(row, entry))
+        {
+            hits.push_back(row);
+        }
+    }
+    std::sort(hits.begin(), hits.end());
+}
+
+bool LogSearchIndex::isHit(const RowIndex row, LogStore::Entry& entry) const
+{
+    return m_store.getEntry(row, entry) && toLowerCase(entry.text).find(m_query) != std::string::npos;
+}
+
+void LogSearchIndex::resetIndex()
+{
+    m_textIds.clear();
+    m_textRows.clear();
+    m_trigramTexts.clear();
+    m_unindexedRows.clear();
+    m_nbRows = 0;
+    m_isTextHit.clear();
+}
+
+} // namespace sofaimgui
@@ -0,0 +1,121 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+
+#include <SofaImGui/LogStore.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sofaimgui
+{
+
+/**
+ * Full-text index of the messages of the log, built by a background thread as the messages are added,
+ * to find the rows containing a text (case-insensitive) without scanning the whole log.
+ *
+ * The distinct texts of the rows are identified by their hash and indexed by their trigrams. The texts
+ * themselves are not kept: a search intersects the texts of the trigrams of the query, and reads one
+ * row of each candidate back from the store to check it. While a query is active, the rows added
+ * afterwards are checked as they are indexed, so that the hits stay up to date.
+ *
+ * Beyond maxIndexedTexts distinct texts, the rows of the new texts are not indexed anymore: they are
+ * all read back from the store at each search. The memory of the index is then bounded, except for a
+ * row index per row.
+ */
+class SOFAIMGUI_API LogSearchIndex
+{
+public:
+    /// Index of a row, which is also the index of its message in the store
+    using RowIndex = std::uint32_t;
+
+    static constexpr std::size_t maxIndexedTexts = std::size_t(1) << 20;
+
+    /// @param store Store of the messages added to the index, read back to check the candidates of a search
+    explicit LogSearchIndex(const LogStore& store);
+    ~LogSearchIndex();
+
+    LogSearchIndex(const LogSearchIndex&) = delete;
+    LogSearchIndex& operator=(const LogSearchIndex&) = delete;
+
+    /// Hands the text of the next row to the indexing thread. The rows are numbered in the order they are added.
+    void add(const std::string& text);
+    /// Removes all the rows
+    void clear();
+
+    /// Starts searching the rows containing the query. An empty query has no hit.
+    void search(const std::string& query);
+
+    /// Revision of the hits, changing each time they are updated
+    std::size_t getRevision() const;
+    /**
+     * Updates a copy of the hits of the last completed search: the rows containing its query, in order.
+     * The hits found since the previous call are appended to the copy, unless the search changed in
+     * between (new query, or rows cleared): the copy is then replaced, and true is returned.
+     * @param searchRevision Revision of the search of the copy, updated by the call
+     */
+    bool updateHits(std::size_t& searchRevision, std::string& query, std::vector<RowIndex>& hits) const;
+    /// True while rows or a query are waiting to be processed
+    bool isBusy() const;
+
+private:
+    void indexLoop();
+    void indexRow(const std::string& text, std::vector<RowIndex>& newHits);
+    void findHits(std::vector<RowIndex>& hits);
+    bool isHit(RowIndex row, LogStore::Entry& entry) const;
+    void resetIndex();
+
+    const LogStore& m_store;
+
+    // shared with the indexing thread, protected by m_mutex
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<std::string> m_pendingTexts;
+    bool m_isClearRequested { false };
+    std::string m_pendingQuery;
+    bool m_isQueryPending { false };
+    bool m_isIndexing { false };
+    bool m_isStopping { false };
+    std::string m_hitsQuery;
+    std::vector<RowIndex> m_hits;
+    std::size_t m_searchRevision {};
+    std::size_t m_revision {};
+
+    // indexing thread
+    std::unordered_map<std::uint64_t, std::uint32_t> m_textIds; ///< hash of a distinct text -> its id
+    std::vector<std::vector<RowIndex>> m_textRows;               ///< rows of each distinct text
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> m_trigramTexts; ///< texts containing each trigram
+    std::vector<RowIndex> m_unindexedRows; ///< rows of the texts beyond maxIndexedTexts
+    std::size_t m_nbRows {};
+    std::string m_query;             ///< lower case
+    std::vector<bool> m_isTextHit;   ///< texts containing the query
+
+    std::thread m_thread;
+};
+
+} // namespace sofaimgui
@@ -0,0 +1,299 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/LogSpillFile.h>
+
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace sofaimgui
+{
+
+namespace
+{
+    constexpr std::size_t lengthSize = sizeof(std::uint32_t);
+
+    std::uint32_t readLength(const char* data)
+    {
+        std::uint32_t length;
+        std::memcpy(&length, data, lengthSize);
+        return length;
+    }
+
+#if !defined(_WIN32)
+    /// Allocates the blocks of a range of the file, growing it if needed. A page of a shared mapping
+    /// whose block cannot be allocated when it is written raises SIGBUS: the disk must be reserved before.
+    bool reserve(const int file, const std::uint64_t offset, const std::size_t size)
+    {
+#if defined(__linux__)
+        return posix_fallocate(file, static_cast<off_t>(offset), static_cast<off_t>(size)) == 0;
+#else
+        // writing the range allocates its blocks
+        static constexpr std::size_t chunkSize = 1 << 16;
+        static const std::vector<char> zeros(chunkSize, 0);
+        for (std::size_t written = 0; written < size;)
+        {
+            const auto result = pwrite(file, zeros.data(), std::min(chunkSize, size - written), static_cast<off_t>(offset + written));
+            if (result <= 0)
+            {
+                return false;
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        return true;
+#endif
+    }
+#endif
+}
+
+LogSpillFile::~LogSpillFile()
+{
+    close();
+}
+
+bool LogSpillFile::open()
+{
+    if (isOpen())
+    {
+        return true;
+    }
+
+    std::error_code error;
+    const auto folder = std::filesystem::temp_directory_path(error);
+    if (error)
+    {
+        return false;
+    }
+
+#if defined(_WIN32)
+    static std::atomic<unsigned int> counter { 0 };
+    const auto path = folder / ("sofaimgui-log-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(counter++) + ".bin");
+    // deleted by the system when its handle is closed, even if the process crashes
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_NEW,
+                                    FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    m_file = file;
+#else
+    std::string path = (folder / "sofaimgui-log-XXXXXX").string();
+    const int file = mkstemp(path.data());
+    if (file < 0)
+    {
+        return false;
+    }
+    // the file has no name anymore: it is deleted when it is closed, even if the process crashes
+    unlink(path.c_str());
+    m_file = file;
+#endif
+    m_fileSize = 0;
+    return true;
+}
+
+bool LogSpillFile::isOpen() const
+{
+#if defined(_WIN32)
+    return m_file != nullptr;
+#else
+    return m_file >= 0;
+#endif
+}
+
+void LogSpillFile::close()
+{
+    if (!isOpen())
+    {
+        return;
+    }
+    unmapSegments();
+#if defined(_WIN32)
+    CloseHandle(m_file);
+    m_file = nullptr;
+#else
+    ::close(m_file);
+    m_file = -1;
+#endif
+    m_blockStarts.clear();
+    m_nbRecords = 0;
+    m_fileSize = 0;
+}
+
+bool LogSpillFile::append(const std::string_view record)
+{
+    if (!isOpen() || record.size() > std::numeric_limits<std::uint32_t>::max())
+    {
+        return false;
+    }
+
+    const std::size_t recordSize = lengthSize + record.size();
+    if (m_segments.empty() || m_segments.back().used + recordSize > m_segments.back().size)
+    {
+        if (!addSegment(recordSize))
+        {
+            return false;
+        }
+    }
+
+    auto& segment = m_segments.back();
+    if (m_nbRecords % blockSize == 0)
+    {
+        m_blockStarts.push_back({static_cast<std::uint32_t>(m_segments.size() - 1), static_cast<std::uint32_t>(segment.used)});
+    }
+    const auto length = static_cast<std::uint32_t>(record.size());
+    std::memcpy(segment.data + segment.used, &length, lengthSize);
+    std::memcpy(segment.data + segment.used + lengthSize, record.data(), record.size());
+    segment.used += recordSize;
+    ++m_nbRecords;
+    return true;
+}
+
+void LogSpillFile::clear()
+{
+    if (!isOpen())
+    {
+        return;
+    }
+    unmapSegments();
+#if defined(_WIN32)
+    LARGE_INTEGER begin {};
+    SetFilePointerEx(m_file, begin, nullptr, FILE_BEGIN);
+    SetEndOfFile(m_file);
+#else
+    [[maybe_unused]] const int result = ftruncate(m_file, 0);
+#endif
+    m_blockStarts.clear();
+    m_nbRecords = 0;
+    m_fileSize = 0;
+}
+
+std::string_view LogSpillFile::getRecord(const std::size_t index) const
+{
+    if (index >= m_nbRecords)
+    {
+        return {};
+    }
+
+    // from the first record of the block, skip the records before the requested one
+    Position position = m_blockStarts[index / blockSize];
+    for (std::size_t i = 0; ; ++i)
+    {
+        const Segment* segment = &m_segments[position.segment];
+        if (position.offset >= segment->used)
+        {
+            // the rest of the segment was too small for the next record
+            ++position.segment;
+            position.offset = 0;
+            segment = &m_segments[position.segment];
+        }
+
+        const char* data = segment->data + position.offset;
+        const std::uint32_t length = readLength(data);
+        if (i == index % blockSize)
+        {
+            return {data + lengthSize, length};
+        }
+        position.offset += static_cast<std::uint32_t>(lengthSize + length);
+    }
+}
+
+bool LogSpillFile::addSegment(const std::size_t minSize)
+{
+    const std::size_t size = (minSize + segmentSize - 1) / segmentSize * segmentSize;
+    const std::uint64_t newFileSize = m_fileSize + size;
+
+    Segment segment;
+    segment.size = size;
+    segment.fileOffset = m_fileSize;
+
+#if defined(_WIN32)
+    // the mapping grows the file to its size, and allocates its clusters since the file is not sparse
+    const HANDLE mapping = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE,
+                                              static_cast<DWORD>(newFileSize >> 32), static_cast<DWORD>(newFileSize & 0xFFFFFFFFu), nullptr);
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS,
+                               static_cast<DWORD>(segment.fileOffset >> 32), static_cast<DWORD>(segment.fileOffset & 0xFFFFFFFFu), size);
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    segment.mapping = mapping;
+#else
+    if (!reserve(m_file, m_fileSize, size))
+    {
+        // a partial reservation is released
+        [[maybe_unused]] const int result = ftruncate(m_file, static_cast<off_t>(m_fileSize));
+        return false;
+    }
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, static_cast<off_t>(segment.fileOffset));
+    if (data == MAP_FAILED)
+    {
+        [[maybe_unused]] const int result = ftruncate(m_file, static_cast<off_t>(m_fileSize));
+        return false;
+    }
+
+    if (!m_segments.empty())
+    {
+        // the previous segment is full: its pages can leave the memory of the process, the system
+        // writes them to the file and reads them back if they are accessed again
+        madvise(m_segments.back().data, m_segments.back().size, MADV_DONTNEED);
+    }
+#endif
+    segment.data = static_cast<char*>(data);
+
+    m_segments.push_back(segment);
+    m_fileSize = newFileSize;
+    return true;
+}
+
+void LogSpillFile::unmapSegments()
+{
+    for (const auto& segment : m_segments)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(segment.data);
+        CloseHandle(segment.mapping);
+#else
+        munmap(segment.data, segment.size);
+#endif
+    }
+    m_segments.clear();
+}
+
+} // namespace sofaimgui
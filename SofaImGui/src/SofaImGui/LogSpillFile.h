@@ -0,0 +1,101 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sofaimgui
+{
+
+/**
+ * Append-only file of records (strings of bytes), memory-mapped to read them back without loading the
+ * whole file: only the pages of the records read are brought back in memory by the system.
+ *
+ * The file is made of segments, mapped separately, so that growing the file never moves the records
+ * already written. A record is never split between two segments. The position of one record out of
+ * blockSize is kept in memory: a record is found from the start of its block.
+ *
+ * The file is created in the temporary folder, and deleted when it is closed, or when the process ends.
+ * The class is not thread-safe.
+ */
+class SOFAIMGUI_API LogSpillFile
+{
+public:
+    LogSpillFile() = default;
+    ~LogSpillFile();
+
+    LogSpillFile(const LogSpillFile&) = delete;
+    LogSpillFile& operator=(const LogSpillFile&) = delete;
+
+    /// Creates the file. Returns false if it cannot be created.
+    bool open();
+    bool isOpen() const;
+    void close();
+
+    /// Appends a record at the end of the file. Returns false if the file cannot grow.
+    bool append(std::string_view record);
+    /// Removes all the records, and shrinks the file
+    void clear();
+
+    std::size_t getNbRecords() const { return m_nbRecords; }
+    /// Content of a record, valid until the file is cleared or closed
+    std::string_view getRecord(std::size_t index) const;
+
+    static constexpr std::size_t segmentSize = std::size_t(64) << 20;
+    static constexpr std::size_t blockSize = 64;
+
+private:
+    struct Segment
+    {
+        char* data { nullptr };
+        std::size_t size {};
+        std::size_t used {};
+        std::uint64_t fileOffset {};
+#if defined(_WIN32)
+        void* mapping { nullptr };
+#endif
+    };
+    struct Position
+    {
+        std::uint32_t segment {};
+        std::uint32_t offset {};
+    };
+
+    bool addSegment(std::size_t minSize);
+    void unmapSegments();
+
+    std::vector<Segment> m_segments;
+    std::vector<Position> m_blockStarts; ///< position of the first record of each block
+    std::size_t m_nbRecords {};
+    std::uint64_t m_fileSize {};
+#if defined(_WIN32)
+    void* m_file { nullptr };
+#else
+    int m_file { -1 };
+#endif
+};
+
+} // namespace sofaimgui
@@ -0,0 +1,305 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/LogStore.h>
+
+#include <sofa/core/objectmodel/Base.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace sofaimgui
+{
+
+namespace
+{
+    using Milliseconds = std::chrono::duration<std::int64_t, std::milli>;
+
+    constexpr std::chrono::seconds bucketPruningPeriod { 10 };
+    /// The number of messages dropped before the next message of a sender is forgotten after this idle time
+    constexpr std::chrono::seconds droppedCountLifetime { 60 };
+
+    /// A record of the file: the type, the time, the number of messages dropped before, then each string preceded by its length
+    void writeEntry(const LogStore::Entry& entry, std::string& record)
+    {
+        record.clear();
+        record.push_back(static_cast<char>(entry.type));
+        const std::int64_t time = std::chrono::duration_cast<Milliseconds>(entry.time.time_since_epoch()).count();
+        record.append(reinterpret_cast<const char*>(&time), sizeof(time));
+        record.append(reinterpret_cast<const char*>(&entry.nbDroppedBefore), sizeof(entry.nbDroppedBefore));
+        for (const std::string* field : {&entry.sender, &entry.componentName, &entry.componentPath, &entry.text})
+        {
+            const auto length = static_cast<std::uint32_t>(field->size());
+            record.append(reinterpret_cast<const char*>(&length), sizeof(length));
+            record.append(*field);
+        }
+    }
+
+    void readEntry(std::string_view record, LogStore::Entry& entry)
+    {
+        entry.type = static_cast<LogStore::Message::Type>(record.front());
+        record.remove_prefix(1);
+        std::int64_t time;
+        std::memcpy(&time, record.data(), sizeof(time));
+        record.remove_prefix(sizeof(time));
+        entry.time = LogStore::Clock::time_point(std::chrono::duration_cast<LogStore::Clock::duration>(Milliseconds(time)));
+        std::memcpy(&entry.nbDroppedBefore, record.data(), sizeof(entry.nbDroppedBefore));
+        record.remove_prefix(sizeof(entry.nbDroppedBefore));
+        for (std::string* field : {&entry.sender, &entry.componentName, &entry.componentPath, &entry.text})
+        {
+            std::uint32_t length;
+            std::memcpy(&length, record.data(), sizeof(length));
+            record.remove_prefix(sizeof(length));
+            field->assign(record.data(), length);
+            record.remove_prefix(length);
+        }
+    }
+}
+
+LogStore& LogStore::getInstance()
+{
+    static LogStore instance;
+    return instance;
+}
+
+void LogStore::process(Message& m)
+{
+    Entry entry;
+    {
+        std::lock_guard lock(m_mutex);
+        if (!acceptMessage(m, entry.nbDroppedBefore))
+        {
+            return;
+        }
+    }
+
+    entry.type = m.type();
+    entry.time = Clock::now();
+    entry.sender = m.sender();
+    if (const auto* nfo = dynamic_cast<sofa::helper::logging::SofaComponentInfo*>(m.componentInfo().get()))
+    {
+        entry.componentName = nfo->name();
+        if (nfo->m_component)
+        {
+            entry.componentPath = nfo->m_component->getPathName();
+        }
+    }
+    entry.text = m.message().str();
+
+    std::lock_guard lock(m_mutex);
+    m_entries.push_back(std::move(entry));
+    if (m_entries.size() > m_memoryCapacity)
+    {
+        spill();
+    }
+}
+
+void LogStore::setMemoryCapacity(const std::size_t nbMessages)
+{
+    std::lock_guard lock(m_mutex);
+    m_memoryCapacity = std::max<std::size_t>(nbMessages, 1);
+    spill();
+}
+
+std::size_t LogStore::getMemoryCapacity() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_memoryCapacity;
+}
+
+void LogStore::setRateLimit(const double messagesPerSecond)
+{
+    std::lock_guard lock(m_mutex);
+    m_rateLimit = std::max(messagesPerSecond, 0.);
+    m_componentBuckets.clear();
+    m_senderBuckets.clear();
+}
+
+double LogStore::getRateLimit() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_rateLimit;
+}
+
+std::size_t LogStore::getNbDroppedMessages() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_nbDroppedMessages;
+}
+
+std::size_t LogStore::getNbMessages() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_spillFile.getNbRecords() + m_entries.size();
+}
+
+std::size_t LogStore::getNbSpilledMessages() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_spillFile.getNbRecords();
+}
+
+bool LogStore::getEntry(const std::size_t index, Entry& entry) const
+{
+    std::lock_guard lock(m_mutex);
+    const std::size_t nbSpilled = m_spillFile.getNbRecords();
+    if (index < nbSpilled)
+    {
+        readEntry(m_spillFile.getRecord(index), entry);
+        return true;
+    }
+    if (index - nbSpilled < m_entries.size())
+    {
+        entry = m_entries[index - nbSpilled];
+        return true;
+    }
+    return false;
+}
+
+void LogStore::clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_entries.clear();
+    m_spillFile.clear();
+    m_hasSpillFailed = false;
+    m_nbDroppedMessages = 0;
+    ++m_nbResets;
+}
+
+std::size_t LogStore::getNbResets() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_nbResets;
+}
+
+void LogStore::spill()
+{
+    // if the file cannot be created or grow, the messages stay in memory rather than being lost
+    if (m_hasSpillFailed || m_entries.size() <= m_memoryCapacity)
+    {
+        return;
+    }
+    if (!m_spillFile.isOpen() && !m_spillFile.open())
+    {
+        m_hasSpillFailed = true;
+        return;
+    }
+
+    std::string record;
+    while (m_entries.size() > m_memoryCapacity)
+    {
+        writeEntry(m_entries.front(), record);
+        if (!m_spillFile.append(record))
+        {
+            m_hasSpillFailed = true;
+            return;
+        }
+        m_entries.pop_front();
+    }
+}
+
+bool LogStore::acceptMessage(const Message& m, std::uint32_t& nbDroppedBefore)
+{
+    if (m_rateLimit <= 0. || m.type() == Message::Error || m.type() == Message::Fatal)
+    {
+        return true;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastBucketPruning > bucketPruningPeriod)
+    {
+        pruneBuckets(now);
+    }
+
+    // the bucket of the component, found from its address rather than from its path, which would have to be built
+    RateBucket* bucket = nullptr;
+    bool isNewBucket = false;
+    const auto* nfo = dynamic_cast<const sofa::helper::logging::SofaComponentInfo*>(m.componentInfo().get());
+    if (nfo && nfo->m_component)
+    {
+        const auto [it, isInserted] = m_componentBuckets.try_emplace(nfo->m_component);
+        bucket = &it->second;
+        isNewBucket = isInserted || bucket->componentName != nfo->name();
+        if (isNewBucket)
+        {
+            *bucket = RateBucket{};
+            bucket->componentName = nfo->name();
+        }
+    }
+    else
+    {
+        const auto [it, isInserted] = m_senderBuckets.try_emplace(m.sender());
+        bucket = &it->second;
+        isNewBucket = isInserted;
+    }
+
+    // a bucket holds at least one message, so that a limit below one message per second still lets some through
+    const double capacity = std::max(m_rateLimit, 1.);
+    if (isNewBucket)
+    {
+        bucket->tokens = capacity;
+    }
+    else
+    {
+        const double elapsed = std::chrono::duration<double>(now - bucket->lastRefill).count();
+        bucket->tokens = std::min(capacity, bucket->tokens + elapsed * m_rateLimit);
+    }
+    bucket->lastRefill = now;
+
+    if (bucket->tokens < 1.)
+    {
+        ++bucket->nbDropped;
+        ++m_nbDroppedMessages;
+        return false;
+    }
+    bucket->tokens -= 1.;
+    nbDroppedBefore = bucket->nbDropped;
+    bucket->nbDropped = 0;
+    return true;
+}
+
+void LogStore::pruneBuckets(const std::chrono::steady_clock::time_point now)
+{
+    m_lastBucketPruning = now;
+
+    // a bucket full again is the same as a new one, unless it still has messages dropped to report
+    const std::chrono::duration<double> refillTime(std::max(m_rateLimit, 1.) / m_rateLimit);
+    const auto prune = [now, refillTime](auto& buckets)
+    {
+        for (auto it = buckets.begin(); it != buckets.end();)
+        {
+            const auto idleTime = now - it->second.lastRefill;
+            if (idleTime >= refillTime && (it->second.nbDropped == 0 || idleTime >= droppedCountLifetime))
+            {
+                it = buckets.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    };
+    prune(m_componentBuckets);
+    prune(m_senderBuckets);
+}
+
+} // namespace sofaimgui
@@ -0,0 +1,136 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+
+#include <SofaImGui/LogSpillFile.h>
+#include <sofa/helper/logging/MessageHandler.h>
+#include <sofa/helper/logging/Message.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace sofaimgui
+{
+
+/**
+ * Messages of the log displayed by the GUI, collected by a message handler.
+ *
+ * The most recent messages are kept in memory, up to the memory capacity. The older ones are moved to
+ * an append-only memory-mapped file (LogSpillFile), from which they are read back only when they are
+ * requested, e.g. when the rows of the Log window showing them are scrolled into view. The memory used
+ * by the texts of the messages is then bounded, however long the simulation runs. It is not the case of
+ * the indices of the Log window (LogCache, LogSearchIndex), which still keep a few tens of bytes per
+ * message.
+ *
+ * The messages are numbered in the order they are received. The handler can receive messages from any
+ * thread.
+ *
+ * Optionally, the messages of each sender are rate-limited: a sender repeating a message at each time
+ * step fills the log, and costs a copy of the message each time. Beyond the rate, the messages of the
+ * sender are counted and dropped before being copied, and the count is attached to the next message of
+ * the sender which is kept. Errors are never dropped.
+ */
+class SOFAIMGUI_API LogStore : public sofa::helper::logging::MessageHandler
+{
+public:
+    using Message = sofa::helper::logging::Message;
+
+    static LogStore& getInstance();
+
+    using Clock = std::chrono::system_clock;
+
+    /// Content of a message, as displayed in the Log window
+    struct Entry
+    {
+        Message::Type type { Message::Info };
+        Clock::time_point time;    ///< when the message has been received
+        std::uint32_t nbDroppedBefore {}; ///< messages of the sender dropped by the rate limit since its previous message
+        std::string sender;
+        std::string componentName; ///< empty if the message is not sent by a component
+        std::string componentPath;
+        std::string text;
+    };
+
+    void process(Message& m) override;
+
+    static constexpr std::size_t defaultMemoryCapacity = 100000;
+    /// Number of messages kept in memory before the older ones are moved to the file
+    void setMemoryCapacity(std::size_t nbMessages);
+    std::size_t getMemoryCapacity() const;
+
+    /// Maximum number of messages kept per second for each sender (the component, or the sender of the
+    /// messages not sent by a component), in bursts of up to a second of messages, and at least one
+    /// message. 0 disables the limit.
+    void setRateLimit(double messagesPerSecond);
+    double getRateLimit() const;
+    /// Number of messages dropped by the rate limit since the messages were cleared
+    std::size_t getNbDroppedMessages() const;
+
+    std::size_t getNbMessages() const;
+    /// Number of messages moved to the file
+    std::size_t getNbSpilledMessages() const;
+    /// Copies a message. Returns false if there is no message at this index.
+    bool getEntry(std::size_t index, Entry& entry) const;
+
+    /// Removes all the messages
+    void clear();
+    /// Number of times the messages have been cleared, to know that the indices designate new messages
+    std::size_t getNbResets() const;
+
+private:
+    LogStore() = default;
+
+    void spill();
+    /// Returns false if the message must be dropped, or the number of messages of its sender dropped before it
+    bool acceptMessage(const Message& m, std::uint32_t& nbDroppedBefore);
+
+    /// Token bucket of a sender
+    struct RateBucket
+    {
+        double tokens {};
+        std::chrono::steady_clock::time_point lastRefill;
+        std::uint32_t nbDropped {};
+        std::string componentName; ///< to detect a bucket left by a deleted component at the same address
+    };
+    /// Forgets the buckets of the senders which stopped sending messages
+    void pruneBuckets(std::chrono::steady_clock::time_point now);
+
+    mutable std::mutex m_mutex;
+    std::deque<Entry> m_entries; ///< the messages kept in memory, the most recent ones
+    LogSpillFile m_spillFile;    ///< the messages before them
+    std::size_t m_memoryCapacity { defaultMemoryCapacity };
+    std::size_t m_nbResets {};
+    bool m_hasSpillFailed { false };
+
+    double m_rateLimit {};
+    std::size_t m_nbDroppedMessages {};
+    std::unordered_map<const void*, RateBucket> m_componentBuckets;
+    std::unordered_map<std::string, RateBucket> m_senderBuckets;
+    std::chrono::steady_clock::time_point m_lastBucketPruning;
+};
+
+} // namespace sofaimgui
@@ -0,0 +1,125 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace sofaimgui
+{
+
+/**
+ * Sequence of values keeping their prefix sums (Fenwick tree): appending or changing a value, computing the
+ * sum of the first values and finding the value containing an offset are logarithmic in the size.
+ * Used to position rows of variable heights without walking all the rows.
+ */
+template<class T>
+class PrefixSumTree
+{
+public:
+    void clear()
+    {
+        m_values.clear();
+        m_tree.assign(1, T{});
+    }
+
+    /// Replaces all the values, in linear time
+    void assign(std::vector<T> values)
+    {
+        m_values = std::move(values);
+        m_tree.assign(m_values.size() + 1, T{});
+        for (std::size_t i = 1; i <= m_values.size(); ++i)
+        {
+            m_tree[i] += m_values[i - 1];
+            const std::size_t parent = i + lowBit(i);
+            if (parent <= m_values.size())
+            {
+                m_tree[parent] += m_tree[i];
+            }
+        }
+    }
+
+    void push_back(T value)
+    {
+        m_values.push_back(value);
+        const std::size_t i = m_values.size();
+        // the new node covers the values ]i - lowBit(i), i]
+        m_tree.push_back(value + prefixSum(i - 1) - prefixSum(i - lowBit(i)));
+    }
+
+    void set(std::size_t index, T value)
+    {
+        const T delta = value - m_values[index];
+        m_values[index] = value;
+        for (std::size_t i = index + 1; i <= m_values.size(); i += lowBit(i))
+        {
+            m_tree[i] += delta;
+        }
+    }
+
+    const T& operator[](std::size_t index) const { return m_values[index]; }
+    std::size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+
+    /// Sum of the first n values
+    T prefixSum(std::size_t n) const
+    {
+        T sum {};
+        for (std::size_t i = n; i > 0; i -= lowBit(i))
+        {
+            sum += m_tree[i];
+        }
+        return sum;
+    }
+
+    T total() const { return prefixSum(m_values.size()); }
+
+    /// Index of the value containing the offset, i.e. the largest index such that prefixSum(index) <= offset,
+    /// clamped to the last value. The values must not be negative.
+    std::size_t find(T offset) const
+    {
+        std::size_t position = 0;
+        std::size_t step = 1;
+        while (step * 2 <= m_values.size())
+        {
+            step *= 2;
+        }
+        for (; step > 0; step /= 2)
+        {
+            if (position + step <= m_values.size() && m_tree[position + step] <= offset)
+            {
+                position += step;
+                offset -= m_tree[position];
+            }
+        }
+        return m_values.empty() ? 0 : std::min(position, m_values.size() - 1);
+    }
+
+private:
+    static std::size_t lowBit(std::size_t i) { return i & (~i + 1); }
+
+    std::vector<T> m_values;
+    std::vector<T> m_tree { T{} }; ///< 1-based, the node i holds the sum of the values ]i - lowBit(i), i]
+};
+
+} // namespace sofaimgui
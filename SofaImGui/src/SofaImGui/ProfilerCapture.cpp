@@ -0,0 +1,473 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/ProfilerCapture.h>
+#include <SofaGLFW/SofaGLFWTraceWriter.h>
+#include <SofaGLFW/SofaGLFWProfileRecorder.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace sofaimgui
+{
+
+void ProfilerCapture::setCapacity(const std::size_t nbFrames)
+{
+    if (nbFrames == getCapacity())
+    {
+        return;
+    }
+
+    ++m_revision;
+    m_isLimitedByEntries = false;
+    m_frames.setCapacity(nbFrames);
+    m_nbFrameEntries = 0;
+    for (std::size_t i = 0; i < m_frames.size(); ++i)
+    {
+        m_nbFrameEntries += m_frames[i].size;
+    }
+    m_frameDurations.setCapacity(nbFrames);
+    for (auto& [id, timer] : m_timers)
+    {
+        timer.durations.setCapacity(nbFrames);
+    }
+}
+
+std::size_t ProfilerCapture::getMaxCapacity() const
+{
+    if (m_nbFrameEntries == 0)
+    {
+        return maxNbEntries;
+    }
+    return std::max<std::size_t>(1, maxNbEntries * m_frames.size() / m_nbFrameEntries);
+}
+
+void ProfilerCapture::addFrame(const Records& records)
+{
+    if (getCapacity() == 0)
+    {
+        return;
+    }
+
+    const std::size_t nbRecords = records.size();
+
+    // grow the arena if the new frame would evict frames while the requested number of frames is not reached
+    if (nbRecords > m_entries.size() || (!m_frames.full() && m_frames.size() * nbRecords + nbRecords > m_entries.size()))
+    {
+        const std::size_t estimatedNbEntries = getCapacity() * nbRecords + getCapacity() * nbRecords / 4;
+        reserveEntries(std::min(maxNbEntries, std::max({nbRecords, 2 * m_entries.size(), estimatedNbEntries})));
+    }
+    if (nbRecords > m_entries.size())
+    {
+        return;
+    }
+
+    // the entries of a frame are contiguous: restart at the beginning of the arena if the end is too short
+    if (m_writePosition + nbRecords > m_entries.size())
+    {
+        // the frames left at the end of the arena by the previous lap are the oldest ones
+        while (!m_frames.empty() && m_frames.front().first >= m_writePosition)
+        {
+            m_isLimitedByEntries |= !m_frames.full();
+            popFrontFrame();
+        }
+        m_writePosition = 0;
+    }
+    const std::size_t first = m_writePosition;
+    const std::size_t last = first + nbRecords;
+
+    // evict the oldest frames overlapping the new one
+    while (!m_frames.empty())
+    {
+        const auto& oldest = m_frames.front();
+        if (oldest.first >= last || oldest.first + oldest.size <= first)
+        {
+            break;
+        }
+        m_isLimitedByEntries |= !m_frames.full();
+        popFrontFrame();
+    }
+
+    for (std::size_t i = 0; i < nbRecords; ++i)
+    {
+        const auto& rec = records[i];
+        auto& entry = m_entries[first + i];
+        entry.time = rec.time;
+        entry.id = rec.id;
+        entry.labelId = internLabel(rec.label);
+        entry.type = rec.type;
+    }
+    m_writePosition = last;
+    if (m_frames.full())
+    {
+        m_nbFrameEntries -= m_frames.front().size;
+    }
+    m_frames.push_back({first, nbRecords});
+    m_nbFrameEntries += nbRecords;
+    ++m_revision;
+
+    // total duration of each timer in this frame
+    std::unordered_map<unsigned int, float> timerDurations;
+    std::unordered_map<unsigned int, sofa::helper::system::thread::ctime_t> beginTimes;
+    for (const auto& entry : getFrame(m_frames.size() - 1))
+    {
+        if (sofaglfw::isBeginRecord(entry.type))
+        {
+            beginTimes[entry.id] = entry.time;
+            auto [it, isNewTimer] = m_timers.try_emplace(entry.id);
+            if (isNewTimer)
+            {
+                // a timer appearing now did not run in the previous frames
+                it->second.label = m_labels[entry.labelId];
+                it->second.durations.setCapacity(getCapacity());
+                for (std::size_t i = 0; i < m_frameDurations.size(); ++i)
+                {
+                    it->second.durations.push_back(0.f);
+                }
+            }
+        }
+        else if (sofaglfw::isEndRecord(entry.type))
+        {
+            const auto beginTime = beginTimes.find(entry.id);
+            if (beginTime != beginTimes.end())
+            {
+                timerDurations[entry.id] += static_cast<float>(toMilliseconds(entry.time - beginTime->second));
+            }
+        }
+    }
+
+    m_frameDurations.push_back(nbRecords >= 2 ? static_cast<float>(toMilliseconds(records.back().time - records.front().time)) : 0.f);
+    for (auto& [id, timer] : m_timers)
+    {
+        const auto duration = timerDurations.find(id);
+        timer.durations.push_back(duration != timerDurations.end() ? duration->second : 0.f);
+    }
+}
+
+void ProfilerCapture::addFrame(const ProfilerCapture& other, const std::size_t frameIndex)
+{
+    const auto frame = other.getFrame(frameIndex);
+    Records records(frame.size());
+    for (std::size_t i = 0; i < frame.size(); ++i)
+    {
+        records[i].time = frame[i].time;
+        records[i].type = frame[i].type;
+        records[i].id = frame[i].id;
+        records[i].label = other.getLabel(frame[i].labelId);
+    }
+    addFrame(records);
+}
+
+void ProfilerCapture::clear()
+{
+    ++m_revision;
+    m_writePosition = 0;
+    m_frames.clear();
+    m_nbFrameEntries = 0;
+    m_isLimitedByEntries = false;
+    m_frameDurations.clear();
+    m_timers.clear();
+}
+
+ProfilerCapture::Frame ProfilerCapture::getFrame(const std::size_t frameIndex) const
+{
+    const auto& range = m_frames[frameIndex];
+    return Frame(m_entries.data() + range.first, range.size);
+}
+
+void ProfilerCapture::computeSpans(const std::size_t frameIndex, std::vector<Span>& spans) const
+{
+    spans.clear();
+    const auto frame = getFrame(frameIndex);
+    if (frame.empty())
+    {
+        return;
+    }
+
+    std::vector<std::size_t> openSpans;
+    for (const auto& entry : frame)
+    {
+        if (sofaglfw::isBeginRecord(entry.type))
+        {
+            openSpans.push_back(spans.size());
+            spans.push_back({entry.id, entry.labelId, static_cast<unsigned int>(openSpans.size() - 1), entry.time, frame.back().time});
+        }
+        else if (sofaglfw::isEndRecord(entry.type))
+        {
+            const auto it = std::find_if(openSpans.rbegin(), openSpans.rend(), [&spans, &entry](const std::size_t spanIndex)
+            {
+                return spans[spanIndex].labelId == entry.labelId;
+            });
+            if (it != openSpans.rend())
+            {
+                // the intervals left open inside the closed one end with it
+                const auto position = static_cast<std::size_t>(std::distance(it, openSpans.rend()) - 1);
+                for (auto i = position; i < openSpans.size(); ++i)
+                {
+                    spans[openSpans[i]].end = entry.time;
+                }
+                openSpans.resize(position);
+            }
+        }
+    }
+}
+
+void ProfilerCapture::computeStatistics(Statistics& statistics) const
+{
+    statistics.nbFrames = getNbFrames();
+    statistics.totalFrameDuration = 0.;
+    statistics.timers.clear();
+    statistics.callTree.assign(1, CallTreeNode{});
+
+    // per label: durations of the steps in which it ran, and number of calls
+    std::vector<std::vector<double>> stepDurations;
+    std::vector<std::size_t> nbCalls;
+
+    std::vector<Span> spans;
+    std::vector<std::size_t> path;
+    std::vector<double> frameTotals;
+    for (std::size_t frameIndex = 0; frameIndex < getNbFrames(); ++frameIndex)
+    {
+        statistics.totalFrameDuration += m_frameDurations[frameIndex];
+        computeSpans(frameIndex, spans);
+
+        frameTotals.assign(m_labels.size(), -1.);
+        path.assign(1, 0);
+        for (const auto& span : spans)
+        {
+            const double duration = toMilliseconds(span.end - span.begin);
+            if (frameTotals[span.labelId] < 0.)
+            {
+                frameTotals[span.labelId] = 0.;
+            }
+            frameTotals[span.labelId] += duration;
+            if (nbCalls.size() <= span.labelId)
+            {
+                nbCalls.resize(m_labels.size(), 0);
+            }
+            ++nbCalls[span.labelId];
+
+            // merge the span in the call tree, below the node of its parent
+            path.resize(span.depth + 1);
+            const auto parentIndex = path.back();
+            const auto [child, isNewChild] = statistics.callTree[parentIndex].children.try_emplace(span.labelId, statistics.callTree.size());
+            const auto nodeIndex = child->second;
+            if (isNewChild)
+            {
+                statistics.callTree.emplace_back().labelId = span.labelId;
+            }
+            auto& node = statistics.callTree[nodeIndex];
+            ++node.nbCalls;
+            node.total += duration;
+            path.push_back(nodeIndex);
+        }
+
+        stepDurations.resize(m_labels.size());
+        for (unsigned int labelId = 0; labelId < frameTotals.size(); ++labelId)
+        {
+            if (frameTotals[labelId] >= 0.)
+            {
+                stepDurations[labelId].push_back(frameTotals[labelId]);
+            }
+        }
+    }
+
+    for (unsigned int labelId = 0; labelId < stepDurations.size(); ++labelId)
+    {
+        auto& durations = stepDurations[labelId];
+        if (durations.empty())
+        {
+            continue;
+        }
+
+        TimerStatistics timer;
+        timer.labelId = labelId;
+        timer.nbCalls = nbCalls[labelId];
+        timer.nbSteps = durations.size();
+        for (const auto d : durations)
+        {
+            timer.total += d;
+        }
+        timer.mean = timer.total / static_cast<double>(durations.size());
+        double variance = 0.;
+        for (const auto d : durations)
+        {
+            variance += (d - timer.mean) * (d - timer.mean);
+        }
+        timer.stddev = durations.size() > 1 ? std::sqrt(variance / static_cast<double>(durations.size() - 1)) : 0.;
+        const auto [minIt, maxIt] = std::minmax_element(durations.begin(), durations.end());
+        timer.min = *minIt;
+        timer.max = *maxIt;
+        const auto p95It = durations.begin() + static_cast<std::ptrdiff_t>((durations.size() - 1) * 95 / 100);
+        std::nth_element(durations.begin(), p95It, durations.end());
+        timer.p95 = *p95It;
+        timer.share = statistics.totalFrameDuration > 0. ? timer.total / statistics.totalFrameDuration : 0.;
+        statistics.timers.push_back(timer);
+    }
+}
+
+const ProfilerCapture::TimerHistory* ProfilerCapture::getTimerHistory(const unsigned int timerId) const
+{
+    const auto it = m_timers.find(timerId);
+    return it != m_timers.end() ? &it->second : nullptr;
+}
+
+bool ProfilerCapture::writeTrace(const std::string& filename) const
+{
+    sofaglfw::SofaGLFWTraceWriter writer(filename);
+    if (!writer.isOpen())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < getNbFrames(); ++i)
+    {
+        const auto frame = getFrame(i);
+        for (const auto& entry : frame)
+        {
+            if (sofaglfw::isBeginRecord(entry.type))
+            {
+                writer.beginEvent(m_labels[entry.labelId], entry.time);
+            }
+            else if (sofaglfw::isEndRecord(entry.type))
+            {
+                writer.endEvent(m_labels[entry.labelId], entry.time);
+            }
+        }
+        if (!frame.empty())
+        {
+            writer.endAllEvents(frame.back().time);
+        }
+    }
+    return true;
+}
+
+bool ProfilerCapture::save(const std::string& filename) const
+{
+    sofaglfw::SofaGLFWProfileRecorder recorder(filename);
+    if (!recorder.isOpen())
+    {
+        return false;
+    }
+
+    for (unsigned int labelId = 0; labelId < m_labels.size(); ++labelId)
+    {
+        recorder.addLabel(labelId, m_labels[labelId]);
+    }
+
+    std::vector<sofaglfw::SofaGLFWProfileRecorder::Entry> entries;
+    for (std::size_t i = 0; i < getNbFrames(); ++i)
+    {
+        const auto frame = getFrame(i);
+        entries.clear();
+        for (const auto& entry : frame)
+        {
+            entries.push_back({entry.time, entry.id, entry.labelId, entry.type});
+        }
+        recorder.recordStep(entries);
+    }
+    recorder.stop();
+    return !recorder.hasFailed();
+}
+
+bool ProfilerCapture::load(const std::string& filename)
+{
+    std::vector<std::string> labels;
+    std::vector<std::vector<sofaglfw::SofaGLFWProfileRecorder::Entry>> steps;
+    sofa::helper::system::thread::ctime_t ticksPerSecond {};
+    if (!sofaglfw::SofaGLFWProfileRecorder::read(filename, labels, steps, ticksPerSecond) || ticksPerSecond <= 0)
+    {
+        return false;
+    }
+
+    clear();
+    setCapacity(std::max(getCapacity(), steps.size()));
+
+    // the times are converted to the ticks of this machine, on which toMilliseconds relies
+    const long double tickRatio = static_cast<long double>(sofa::helper::system::thread::CTime::getTicksPerSec()) / static_cast<long double>(ticksPerSecond);
+    Records records;
+    for (const auto& step : steps)
+    {
+        records.resize(step.size());
+        for (std::size_t i = 0; i < step.size(); ++i)
+        {
+            auto& record = records[i];
+            record.time = static_cast<sofa::helper::system::thread::ctime_t>(static_cast<long double>(step[i].time) * tickRatio);
+            record.type = step[i].type;
+            record.id = step[i].id;
+            record.label = step[i].labelId < labels.size() ? labels[step[i].labelId] : std::string();
+        }
+        addFrame(records);
+    }
+    return true;
+}
+
+double ProfilerCapture::toMilliseconds(const sofa::helper::system::thread::ctime_t t)
+{
+    static const auto timerFrequency = static_cast<double>(sofa::helper::system::thread::CTime::getTicksPerSec());
+    return 1000.0 * static_cast<double>(t) / timerFrequency;
+}
+
+unsigned int ProfilerCapture::internLabel(const std::string& label)
+{
+    const auto [it, isNewLabel] = m_labelIds.try_emplace(label, static_cast<unsigned int>(m_labels.size()));
+    if (isNewLabel)
+    {
+        m_labels.push_back(label);
+    }
+    return it->second;
+}
+
+void ProfilerCapture::popFrontFrame()
+{
+    // the summaries stay aligned with the frames
+    m_nbFrameEntries -= m_frames.front().size;
+    m_frames.pop_front();
+    m_frameDurations.pop_front();
+    for (auto& [id, timer] : m_timers)
+    {
+        timer.durations.pop_front();
+    }
+}
+
+void ProfilerCapture::reserveEntries(const std::size_t nbEntries)
+{
+    if (nbEntries <= m_entries.size())
+    {
+        return;
+    }
+
+    // the frames are moved at the beginning of the new arena, from the oldest one
+    std::vector<Entry> entries(nbEntries);
+    std::size_t position = 0;
+    for (std::size_t i = 0; i < m_frames.size(); ++i)
+    {
+        auto range = m_frames[i];
+        std::copy_n(m_entries.begin() + range.first, range.size, entries.begin() + position);
+        range.first = position;
+        m_frames.set(i, range);
+        position += range.size;
+    }
+    m_entries = std::move(entries);
+    m_writePosition = position;
+}
+
+} // namespace sofaimgui
@@ -0,0 +1,204 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+#include <SofaImGui/RingBuffer.h>
+#include <SofaGLFW/SofaGLFWTimerRecords.h>
+
+#include <sofa/helper/AdvancedTimer.h>
+#include <sofa/type/vector.h>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sofaimgui
+{
+
+/**
+ * Records of the AdvancedTimer collected over the last time steps.
+ *
+ * The records are stored compactly: each one is reduced to a POD entry (timer id, interned label,
+ * type and time) in a fixed-capacity arena used as a ring. The entries of a frame are always
+ * contiguous in the arena, and writing a new frame evicts the oldest ones it overlaps. The arena
+ * only grows when it cannot hold the requested number of frames.
+ *
+ * The summaries displayed in the charts (duration of the steps, and total duration of each timer
+ * in each step) are computed once, when the records of a step are added, and kept in ring buffers
+ * aligned with the frames.
+ */
+class SOFAIMGUI_API ProfilerCapture
+{
+public:
+    using Records = sofa::type::vector<sofa::helper::Record>;
+
+    struct Entry
+    {
+        sofa::helper::system::thread::ctime_t time {};
+        unsigned int id {};
+        unsigned int labelId {}; ///< index in the table of interned labels
+        sofa::helper::Record::Type type { sofa::helper::Record::RNONE };
+    };
+
+    /// Entries of a frame, contiguous in the arena. Invalidated when a frame is added.
+    class Frame
+    {
+    public:
+        Frame(const Entry* first, std::size_t size) : m_first(first), m_size(size) {}
+        const Entry* begin() const { return m_first; }
+        const Entry* end() const { return m_first + m_size; }
+        const Entry& operator[](std::size_t i) const { return m_first[i]; }
+        const Entry& front() const { return m_first[0]; }
+        const Entry& back() const { return m_first[m_size - 1]; }
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+    private:
+        const Entry* m_first;
+        std::size_t m_size;
+    };
+
+    /// Interval between a begin record and the matching end record
+    struct Span
+    {
+        unsigned int id {};
+        unsigned int labelId {};
+        unsigned int depth {}; ///< 0 for the root timer
+        sofa::helper::system::thread::ctime_t begin {};
+        sofa::helper::system::thread::ctime_t end {};
+    };
+
+    /// Statistics of a timer label over all the frames. The per-step values are the total time of the
+    /// timer in a step, over the steps in which it ran.
+    struct TimerStatistics
+    {
+        unsigned int labelId {};
+        std::size_t nbCalls {};
+        std::size_t nbSteps {};
+        double total {}; ///< ms
+        double mean {};  ///< per step, ms
+        double min {};   ///< per step, ms
+        double max {};   ///< per step, ms
+        double p95 {};   ///< per step, ms
+        double stddev {}; ///< per step, ms
+        double share {}; ///< fraction of the total duration of the frames
+    };
+
+    /// Node of the call tree averaged over all the frames: timers are merged by label along their call path
+    struct CallTreeNode
+    {
+        unsigned int labelId {};
+        std::size_t nbCalls {};
+        double total {}; ///< ms
+        std::map<unsigned int, std::size_t> children; ///< label id -> index of the child node
+    };
+
+    struct Statistics
+    {
+        std::size_t nbFrames {};
+        double totalFrameDuration {}; ///< ms
+        std::vector<TimerStatistics> timers;
+        std::vector<CallTreeNode> callTree; ///< the first node is a virtual root
+    };
+
+    struct TimerHistory
+    {
+        std::string label;
+        RingBuffer<float> durations; ///< total duration of the timer in each frame (ms)
+    };
+
+    /// The arena is never grown beyond this number of entries (about 100 MB)
+    static constexpr std::size_t maxNbEntries = std::size_t(1) << 22;
+
+    /// Number of frames kept. The oldest frames are discarded first.
+    void setCapacity(std::size_t nbFrames);
+    std::size_t getCapacity() const { return m_frames.capacity(); }
+    /// Number of frames the arena can hold at most, estimated from the size of the frames kept
+    std::size_t getMaxCapacity() const;
+    /// True if frames have been discarded because the arena is full, before the capacity was reached
+    bool isLimitedByEntries() const { return m_isLimitedByEntries; }
+
+    void addFrame(const Records& records);
+    /// Copies a frame of another capture
+    void addFrame(const ProfilerCapture& other, std::size_t frameIndex);
+    void clear();
+
+    std::size_t getNbFrames() const { return m_frames.size(); }
+    Frame getFrame(std::size_t frameIndex) const;
+
+    const std::string& getLabel(unsigned int labelId) const { return m_labels[labelId]; }
+
+    /// Intervals of a frame, in the order of their begin records. An end record closes the innermost
+    /// interval with the same label; the intervals left open end at the last record of the frame.
+    void computeSpans(std::size_t frameIndex, std::vector<Span>& spans) const;
+
+    /// Duration of each frame (ms), aligned with the frames
+    const RingBuffer<float>& getFrameDurations() const { return m_frameDurations; }
+
+    /// History of a timer, or nullptr if it has never been recorded
+    const TimerHistory* getTimerHistory(unsigned int timerId) const;
+
+    /// Aggregates all the frames. Linear in the number of records.
+    void computeStatistics(Statistics& statistics) const;
+
+    /// Incremented each time the content of the capture changes
+    std::size_t getRevision() const { return m_revision; }
+
+    /// Writes all the frames in a Chrome Trace / Perfetto JSON file
+    bool writeTrace(const std::string& filename) const;
+
+    /// Writes all the frames in the binary format of SofaGLFWProfileRecorder
+    bool save(const std::string& filename) const;
+
+    /// Replaces the frames by the ones of a file written by save or by SofaGLFWProfileRecorder. The
+    /// capacity is increased if needed to hold all the frames of the file.
+    bool load(const std::string& filename);
+
+    static double toMilliseconds(sofa::helper::system::thread::ctime_t t);
+
+private:
+    struct FrameRange
+    {
+        std::size_t first {};
+        std::size_t size {};
+    };
+
+    unsigned int internLabel(const std::string& label);
+    void popFrontFrame();
+    void reserveEntries(std::size_t nbEntries);
+
+    std::vector<Entry> m_entries; ///< arena
+    std::size_t m_writePosition {};
+    RingBuffer<FrameRange> m_frames;
+    std::size_t m_nbFrameEntries {}; ///< entries of the frames kept
+    bool m_isLimitedByEntries { false };
+
+    std::vector<std::string> m_labels;
+    std::unordered_map<std::string, unsigned int> m_labelIds;
+
+    RingBuffer<float> m_frameDurations;
+    std::map<unsigned int, TimerHistory> m_timers;
+    std::size_t m_revision {};
+};
+
+} // namespace sofaimgui
@@ -0,0 +1,110 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/ProfilingState.h>
+
+#include <sofa/helper/AdvancedTimer.h>
+
+#include <algorithm>
+
+namespace sofaimgui
+{
+
+void ProfilingState::setMode(const Mode mode)
+{
+    if (mode != m_mode)
+    {
+        m_mode = mode;
+        m_stepCounter = 0;
+    }
+}
+
+void ProfilingState::setSamplingPeriod(const unsigned int nbSteps)
+{
+    const unsigned int samplingPeriod = std::max(1u, nbSteps);
+    if (samplingPeriod != m_samplingPeriod)
+    {
+        m_samplingPeriod = samplingPeriod;
+        m_stepCounter = 0;
+    }
+}
+
+void ProfilingState::setSuspended(const bool isSuspended)
+{
+    if (isSuspended != m_isSuspended)
+    {
+        m_isSuspended = isSuspended;
+    }
+}
+
+void ProfilingState::setTimerRequired(const bool isRequired)
+{
+    if (isRequired != m_isTimerRequired)
+    {
+        m_isTimerRequired = isRequired;
+    }
+}
+
+void ProfilingState::prepareNextStep()
+{
+    // the timer is only reconfigured here, between two steps: isRecording() tells the consumers of the
+    // records of the next step whether it has been recorded, whatever changes are made in the meantime
+    m_isRecording = isStepRecorded();
+    applyTimerState(m_isRecording);
+    ++m_stepCounter;
+}
+
+bool ProfilingState::isStepRecorded() const
+{
+    if (m_isSuspended)
+    {
+        return false;
+    }
+
+    switch (m_mode)
+    {
+        case Mode::Continuous: return true;
+        case Mode::Sampled: return m_stepCounter % m_samplingPeriod == 0;
+        default: return false;
+    }
+}
+
+void ProfilingState::applyTimerState(const bool isRecording)
+{
+    // the timer is shared: it is never disabled while another consumer requires its records
+    const bool isEnabled = isRecording || m_isTimerRequired;
+    if (isEnabled == m_isTimerEnabled)
+    {
+        return;
+    }
+
+    if (isEnabled && !m_isTimerConfigured)
+    {
+        // the records of each step are kept by the timer to be collected after the step
+        sofa::helper::AdvancedTimer::setInterval("Animate", 1);
+        sofa::helper::AdvancedTimer::setOutputType("Animate", "gui");
+        m_isTimerConfigured = true;
+    }
+    sofa::helper::AdvancedTimer::setEnabled("Animate", isEnabled);
+    m_isTimerEnabled = isEnabled;
+}
+
+} // namespace sofaimgui
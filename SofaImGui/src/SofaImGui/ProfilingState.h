@@ -0,0 +1,84 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+
+#include <cstddef>
+
+namespace sofaimgui
+{
+
+/**
+ * Controls the recording of the "Animate" AdvancedTimer for the Profiler.
+ *
+ * The timer is only reconfigured on transitions (change of mode, suspension, or switch between a
+ * sampled and a skipped step), never on every frame. The changes of the state are applied to the timer
+ * in prepareNextStep, so that they only affect the next time step. When it is off, the Profiler does
+ * not collect anything, and the timer is disabled unless another consumer of its records requires it.
+ */
+class SOFAIMGUI_API ProfilingState
+{
+public:
+    enum class Mode
+    {
+        Off,        ///< the timer is disabled
+        Sampled,    ///< one step recorded every sampling period
+        Continuous  ///< every step is recorded
+    };
+
+    void setMode(Mode mode);
+    Mode getMode() const { return m_mode; }
+
+    /// Number of steps between two recorded steps, in the sampled mode
+    void setSamplingPeriod(unsigned int nbSteps);
+    unsigned int getSamplingPeriod() const { return m_samplingPeriod; }
+
+    /// Disables the recording whatever the mode, e.g. while the Profiler window is closed
+    void setSuspended(bool isSuspended);
+    bool isSuspended() const { return m_isSuspended; }
+
+    /// Keeps the timer enabled whatever the mode, while other consumers of its records (e.g. a trace file) need it
+    void setTimerRequired(bool isRequired);
+    bool isTimerRequired() const { return m_isTimerRequired; }
+
+    /// True if the last time step has been recorded for the Profiler. Only updated by prepareNextStep.
+    bool isRecording() const { return m_isRecording; }
+
+    /// To call once the records of a time step have been collected, before the next step: applies the
+    /// changes of the state to the timer
+    void prepareNextStep();
+
+private:
+    bool isStepRecorded() const;
+    void applyTimerState(bool isRecording);
+
+    Mode m_mode { Mode::Continuous };
+    unsigned int m_samplingPeriod { 10 };
+    bool m_isSuspended { true };
+    std::size_t m_stepCounter {};
+    bool m_isTimerRequired { false };
+    bool m_isRecording { false };
+    bool m_isTimerEnabled { false };
+    bool m_isTimerConfigured { false };
+};
+
+} // namespace sofaimgui
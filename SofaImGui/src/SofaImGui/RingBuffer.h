@@ -0,0 +1,135 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace sofaimgui
+{
+
+/**
+ * Fixed-capacity circular buffer: once full, pushing an element overwrites the oldest one.
+ * Elements are indexed from the oldest (0) to the most recent (size() - 1).
+ *
+ * Each element is stored twice, at its position in the ring and capacity() elements further, so that
+ * the elements are always contiguous from the oldest one: data() can be given directly to ImPlot, and
+ * removing the oldest element is done in constant time. Elements are then modified through set().
+ */
+template<class T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(std::size_t capacity = 0)
+    {
+        setCapacity(capacity);
+    }
+
+    /// Changes the capacity, keeping the most recent elements
+    void setCapacity(std::size_t capacity)
+    {
+        if (capacity == m_capacity)
+        {
+            return;
+        }
+
+        const std::size_t nbKept = std::min(m_size, capacity);
+        std::vector<T> data(2 * capacity);
+        for (std::size_t i = 0; i < nbKept; ++i)
+        {
+            data[i] = (*this)[m_size - nbKept + i];
+            data[i + capacity] = data[i];
+        }
+        m_data = std::move(data);
+        m_capacity = capacity;
+        m_size = nbKept;
+        m_first = 0;
+    }
+
+    void push_back(T value)
+    {
+        if (m_capacity == 0)
+        {
+            return;
+        }
+        std::size_t position = (m_first + m_size) % m_capacity;
+        if (m_size < m_capacity)
+        {
+            ++m_size;
+        }
+        else
+        {
+            // overwrite the oldest element
+            m_first = (m_first + 1) % m_capacity;
+        }
+        m_data[position + m_capacity] = value;
+        m_data[position] = std::move(value);
+    }
+
+    /// Removes the oldest element
+    void pop_front()
+    {
+        if (m_size == 0)
+        {
+            return;
+        }
+        m_first = (m_first + 1) % m_capacity;
+        --m_size;
+    }
+
+    void clear()
+    {
+        m_size = 0;
+        m_first = 0;
+    }
+
+    /// Replaces the element at index i
+    void set(std::size_t i, T value)
+    {
+        const std::size_t position = (m_first + i) % m_capacity;
+        m_data[position + m_capacity] = value;
+        m_data[position] = std::move(value);
+    }
+
+    const T& operator[](std::size_t i) const { return m_data[m_first + i]; }
+
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[m_size - 1]; }
+
+    std::size_t size() const { return m_size; }
+    std::size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+    bool full() const { return m_size == m_capacity; }
+
+    /// Contiguous elements, from the oldest one
+    const T* data() const { return m_data.data() + m_first; }
+
+private:
+    std::vector<T> m_data;    ///< the ring, followed by its copy
+    std::size_t m_capacity {};
+    std::size_t m_first {};   ///< position of the oldest element in the ring
+    std::size_t m_size {};
+};
+
+} // namespace sofaimgui
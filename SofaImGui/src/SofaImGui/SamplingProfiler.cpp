@@ -0,0 +1,398 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/SamplingProfiler.h>
+
+#include <sofa/helper/logging/Messaging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#define SOFAIMGUI_HAS_SAMPLING_PROFILER
+#endif
+
+#if defined(SOFAIMGUI_HAS_SAMPLING_PROFILER)
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+#endif // defined(SOFAIMGUI_HAS_SAMPLING_PROFILER)
+
+namespace sofaimgui
+{
+
+namespace
+{
+#if defined(SOFAIMGUI_HAS_SAMPLING_PROFILER)
+    /// Ring of the running profiler, written by the signal handler. Only one thread is sampled at a time.
+    std::atomic<void*> s_activeRing { nullptr };
+#endif
+}
+
+SamplingProfiler::SamplingProfiler() = default;
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+bool SamplingProfiler::isAvailable()
+{
+#if defined(SOFAIMGUI_HAS_SAMPLING_PROFILER)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(SOFAIMGUI_HAS_SAMPLING_PROFILER)
+namespace
+{
+    /**
+     * Captures the stack interrupted by the signal, from its context. Only async-signal-safe code: the
+     * frame pointers are followed while they point upwards inside the stack of the thread, where each
+     * frame starts with the frame pointer of the caller followed by the return address.
+     */
+    template<class Ring, class Sample>
+    void captureStack(Ring* ring, const ucontext_t* context)
+    {
+        const std::size_t writeIndex = ring->writeIndex.load(std::memory_order_relaxed);
+        const std::size_t readIndex = ring->readIndex.load(std::memory_order_acquire);
+        if (writeIndex - readIndex >= Ring::capacity)
+        {
+            ring->nbDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+#if defined(__x86_64__)
+        const auto pc = static_cast<std::uintptr_t>(context->uc_mcontext.gregs[REG_RIP]);
+        auto fp = static_cast<std::uintptr_t>(context->uc_mcontext.gregs[REG_RBP]);
+        const auto sp = static_cast<std::uintptr_t>(context->uc_mcontext.gregs[REG_RSP]);
+#else
+        const auto pc = static_cast<std::uintptr_t>(context->uc_mcontext.pc);
+        auto fp = static_cast<std::uintptr_t>(context->uc_mcontext.regs[29]);
+        const auto sp = static_cast<std::uintptr_t>(context->uc_mcontext.sp);
+#endif
+
+        Sample& sample = ring->samples[writeIndex % Ring::capacity];
+        sample.frames[0] = reinterpret_cast<void*>(pc);
+        std::size_t depth = 1;
+
+        std::uintptr_t lowerBound = std::max(sp, ring->stackBegin);
+        while (depth < SamplingProfiler::maxDepth
+               && fp >= lowerBound && fp <= ring->stackEnd - 2 * sizeof(std::uintptr_t)
+               && fp % sizeof(std::uintptr_t) == 0)
+        {
+            const auto* frame = reinterpret_cast<const std::uintptr_t*>(fp);
+            const std::uintptr_t returnAddress = frame[1];
+            if (returnAddress == 0)
+            {
+                break;
+            }
+            sample.frames[depth++] = reinterpret_cast<void*>(returnAddress);
+
+            // the frame of the caller is higher in the stack: this also stops on a loop
+            lowerBound = fp + 2 * sizeof(std::uintptr_t);
+            fp = frame[0];
+        }
+        sample.depth = depth;
+        ring->writeIndex.store(writeIndex + 1, std::memory_order_release);
+    }
+
+    /// Bounds of the stack of the calling thread
+    bool getStackBounds(std::uintptr_t& begin, std::uintptr_t& end)
+    {
+        pthread_attr_t attributes;
+        if (pthread_getattr_np(pthread_self(), &attributes) != 0)
+        {
+            return false;
+        }
+        void* address = nullptr;
+        std::size_t size = 0;
+        const bool isValid = pthread_attr_getstack(&attributes, &address, &size) == 0;
+        pthread_attr_destroy(&attributes);
+        begin = reinterpret_cast<std::uintptr_t>(address);
+        end = begin + size;
+        return isValid && size > 0;
+    }
+}
+#endif
+
+bool SamplingProfiler::start(const unsigned int frequency)
+{
+#if defined(SOFAIMGUI_HAS_SAMPLING_PROFILER)
+    if (m_isRunning || frequency == 0)
+    {
+        return false;
+    }
+
+    struct ActiveRing
+    {
+        static void handleSignal(int, siginfo_t*, void* context)
+        {
+            const int savedErrno = errno;
+            if (auto* ring = static_cast<SampleRing*>(s_activeRing.load(std::memory_order_acquire)))
+            {
+                captureStack<SampleRing, Sample>(ring, static_cast<const ucontext_t*>(context));
+            }
+            errno = savedErrno;
+        }
+    };
+
+    // the handler is never uninstalled: a signal may still be pending when the timer is deleted
+    static const bool isHandlerInstalled = []
+    {
+        struct sigaction action {};
+        action.sa_sigaction = &ActiveRing::handleSignal;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        return sigaction(SIGPROF, &action, nullptr) == 0;
+    }();
+    if (!isHandlerInstalled)
+    {
+        msg_error("SamplingProfiler") << "Cannot install the SIGPROF handler: " << std::strerror(errno);
+        return false;
+    }
+
+    if (!m_ring)
+    {
+        m_ring = std::make_unique<SampleRing>();
+    }
+    m_ring->writeIndex = 0;
+    m_ring->readIndex = 0;
+    if (!getStackBounds(m_ring->stackBegin, m_ring->stackEnd))
+    {
+        msg_error("SamplingProfiler") << "Cannot get the stack of the thread";
+        return false;
+    }
+
+    // the timer runs on the CPU time of the calling thread, and the signal is sent to this thread
+    clockid_t clock {};
+    if (pthread_getcpuclockid(pthread_self(), &clock) != 0)
+    {
+        msg_error("SamplingProfiler") << "Cannot get the CPU clock of the thread";
+        return false;
+    }
+
+    sigevent event {};
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+
+    timer_t timer {};
+    if (timer_create(clock, &event, &timer) != 0)
+    {
+        msg_error("SamplingProfiler") << "Cannot create the sampling timer: " << std::strerror(errno);
+        return false;
+    }
+
+    s_activeRing.store(m_ring.get(), std::memory_order_release);
+
+    const long period = std::max(1L, 1000000000L / static_cast<long>(frequency));
+    itimerspec spec {};
+    spec.it_interval.tv_sec = period / 1000000000L;
+    spec.it_interval.tv_nsec = period % 1000000000L;
+    spec.it_value = spec.it_interval;
+    if (timer_settime(timer, 0, &spec, nullptr) != 0)
+    {
+        msg_error("SamplingProfiler") << "Cannot start the sampling timer: " << std::strerror(errno);
+        s_activeRing.store(nullptr, std::memory_order_release);
+        timer_delete(timer);
+        return false;
+    }
+    m_timer = timer;
+
+    m_isStopping = false;
+    m_thread = std::thread(&SamplingProfiler::aggregateLoop, this);
+    m_isRunning = true;
+    return true;
+#else
+    (void)frequency;
+    return false;
+#endif
+}
+
+void SamplingProfiler::stop()
+{
+#if defined(SOFAIMGUI_HAS_SAMPLING_PROFILER)
+    if (!m_isRunning)
+    {
+        return;
+    }
+
+    timer_delete(static_cast<timer_t>(m_timer));
+    m_timer = nullptr;
+    s_activeRing.store(nullptr, std::memory_order_release);
+
+    {
+        std::lock_guard lock(m_stopMutex);
+        m_isStopping = true;
+    }
+    m_stopCondition.notify_one();
+    m_thread.join();
+    m_isRunning = false;
+#endif
+}
+
+void SamplingProfiler::reset()
+{
+    std::lock_guard lock(m_resultsMutex);
+    m_results = Results{};
+    m_results.callTree.emplace_back();
+    m_functionIds.clear();
+    m_lastSeenSample.clear();
+    m_symbolCache.clear();
+    m_revision.fetch_add(1, std::memory_order_release);
+}
+
+void SamplingProfiler::getResults(Results& results) const
+{
+    std::lock_guard lock(m_resultsMutex);
+    results = m_results;
+}
+
+void SamplingProfiler::aggregateLoop()
+{
+    bool isStopping = false;
+    while (!isStopping)
+    {
+        {
+            std::unique_lock lock(m_stopMutex);
+            isStopping = m_stopCondition.wait_for(lock, std::chrono::milliseconds(50), [this]{ return m_isStopping; });
+        }
+
+        const std::size_t readIndex = m_ring->readIndex.load(std::memory_order_relaxed);
+        const std::size_t writeIndex = m_ring->writeIndex.load(std::memory_order_acquire);
+        if (readIndex == writeIndex)
+        {
+            continue;
+        }
+
+        {
+            std::lock_guard lock(m_resultsMutex);
+            if (m_results.callTree.empty())
+            {
+                m_results.callTree.emplace_back();
+            }
+            for (std::size_t i = readIndex; i < writeIndex; ++i)
+            {
+                aggregate(m_ring->samples[i % SampleRing::capacity]);
+            }
+            m_results.nbDroppedSamples = m_ring->nbDropped.load(std::memory_order_relaxed);
+        }
+        m_ring->readIndex.store(writeIndex, std::memory_order_release);
+        m_revision.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void SamplingProfiler::aggregate(const Sample& sample)
+{
+    if (sample.depth == 0)
+    {
+        return;
+    }
+
+    // from the outermost function to the interrupted one. The other frames are return addresses:
+    // the address before is inside the call instruction.
+    m_stackFunctions.clear();
+    for (std::size_t i = sample.depth; i-- > 0;)
+    {
+        auto* address = static_cast<char*>(sample.frames[i]);
+        m_stackFunctions.push_back(symbolize(i > 0 ? address - 1 : address));
+    }
+
+    const std::size_t sampleNumber = ++m_results.nbSamples;
+    ++m_results.callTree[0].samples;
+    std::size_t nodeIndex = 0;
+    for (const auto functionId : m_stackFunctions)
+    {
+        const auto [child, isNewChild] = m_results.callTree[nodeIndex].children.try_emplace(functionId, m_results.callTree.size());
+        nodeIndex = child->second;
+        if (isNewChild)
+        {
+            m_results.callTree.emplace_back().functionId = functionId;
+        }
+        ++m_results.callTree[nodeIndex].samples;
+
+        // a recursive function is counted once per stack
+        if (m_lastSeenSample[functionId] != sampleNumber)
+        {
+            m_lastSeenSample[functionId] = sampleNumber;
+            ++m_results.statistics[functionId].totalSamples;
+        }
+    }
+    ++m_results.statistics[m_stackFunctions.back()].selfSamples;
+}
+
+unsigned int SamplingProfiler::symbolize(void* address)
+{
+    const auto cached = m_symbolCache.find(address);
+    if (cached != m_symbolCache.end())
+    {
+        return cached->second;
+    }
+
+    std::string name;
+#if defined(SOFAIMGUI_HAS_SAMPLING_PROFILER)
+    Dl_info info {};
+    if (dladdr(address, &info) != 0 && info.dli_sname != nullptr)
+    {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        name = (status == 0 && demangled != nullptr) ? demangled : info.dli_sname;
+        std::free(demangled);
+    }
+    else if (info.dli_fname != nullptr)
+    {
+        // no symbol (e.g. a static function): the samples are grouped by library
+        const std::string library = info.dli_fname;
+        name = "[" + library.substr(library.find_last_of('/') + 1) + "]";
+    }
+#endif
+    if (name.empty())
+    {
+        name = "[unknown]";
+    }
+
+    const auto [it, isNewFunction] = m_functionIds.try_emplace(name, static_cast<unsigned int>(m_results.functions.size()));
+    if (isNewFunction)
+    {
+        m_results.functions.push_back(name);
+        m_results.statistics.push_back({it->second, 0, 0});
+        m_lastSeenSample.push_back(0);
+    }
+    m_symbolCache.emplace(address, it->second);
+    return it->second;
+}
+
+} // namespace sofaimgui
@@ -0,0 +1,143 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sofaimgui
+{
+
+/**
+ * Statistical profiler of a thread: its call stack is captured at a regular rate of its CPU time, and
+ * the stacks are symbolized and aggregated in a background thread. It finds the hotspots in the code
+ * which is not instrumented with the AdvancedTimer.
+ *
+ * The stacks are captured in a SIGPROF handler, triggered by a POSIX timer on the CPU clock of the
+ * sampled thread. The handler only follows the frame pointers from the interrupted frame, within the
+ * stack of the thread, and writes the raw return addresses in a preallocated lock-free ring: nothing
+ * in it allocates or takes a lock. The stacks stop at the first function built without frame pointers
+ * (-fno-omit-frame-pointer). Only available on Linux, on x86-64 and AArch64.
+ */
+class SOFAIMGUI_API SamplingProfiler
+{
+public:
+    /// Samples of a function over all the stacks
+    struct FunctionStatistics
+    {
+        unsigned int functionId {};
+        std::size_t selfSamples {};  ///< stacks in which the function is the leaf
+        std::size_t totalSamples {}; ///< stacks in which the function appears
+    };
+
+    /// Node of the merged call stacks, from the outermost function
+    struct CallTreeNode
+    {
+        unsigned int functionId {};
+        std::size_t samples {};
+        std::map<unsigned int, std::size_t> children; ///< function id -> index of the child node
+    };
+
+    struct Results
+    {
+        std::size_t nbSamples {};
+        std::size_t nbDroppedSamples {}; ///< captured while the ring was full
+        std::vector<std::string> functions; ///< names, indexed by function id
+        std::vector<FunctionStatistics> statistics; ///< one per function
+        std::vector<CallTreeNode> callTree; ///< the first node is a virtual root
+    };
+
+    SamplingProfiler();
+    ~SamplingProfiler();
+
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    static bool isAvailable();
+
+    /// Starts sampling the calling thread, at the given number of samples per second of its CPU time
+    bool start(unsigned int frequency);
+    void stop();
+    bool isRunning() const { return m_isRunning; }
+
+    /// Forgets the aggregated samples
+    void reset();
+
+    /// Incremented each time the results change
+    std::size_t getRevision() const { return m_revision.load(std::memory_order_acquire); }
+    void getResults(Results& results) const;
+
+    /// Maximum number of frames kept in a stack
+    static constexpr std::size_t maxDepth = 64;
+
+private:
+    struct Sample
+    {
+        std::size_t depth {};
+        void* frames[maxDepth] {};
+    };
+
+    struct SampleRing
+    {
+        static constexpr std::size_t capacity = 4096;
+        Sample samples[capacity];
+        /// bounds of the stack of the sampled thread, out of which no frame pointer is followed
+        std::uintptr_t stackBegin {};
+        std::uintptr_t stackEnd {};
+        std::atomic<std::size_t> writeIndex {};
+        std::atomic<std::size_t> readIndex {};
+        std::atomic<std::size_t> nbDropped {};
+    };
+
+    void aggregateLoop();
+    void aggregate(const Sample& sample);
+    unsigned int symbolize(void* address);
+
+    std::unique_ptr<SampleRing> m_ring;
+    bool m_isRunning { false };
+    void* m_timer { nullptr };
+
+    std::thread m_thread;
+    std::mutex m_stopMutex;
+    std::condition_variable m_stopCondition;
+    bool m_isStopping { false };
+
+    // written by the aggregation thread, protected by m_resultsMutex
+    mutable std::mutex m_resultsMutex;
+    Results m_results; ///< the statistics are indexed by function id
+    std::unordered_map<std::string, unsigned int> m_functionIds;
+    std::unordered_map<void*, unsigned int> m_symbolCache;
+    std::vector<std::size_t> m_lastSeenSample; ///< function id -> last sample in which it was counted
+    std::vector<unsigned int> m_stackFunctions;
+    std::atomic<std::size_t> m_revision {};
+};
+
+} // namespace sofaimgui
@@ -0,0 +1,117 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <SofaImGui/SpikeCapture.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace sofaimgui
+{
+
+bool SpikeCapture::onFrameAdded(const ProfilerCapture& capture)
+{
+    if (capture.getNbFrames() == 0)
+    {
+        return false;
+    }
+
+    const std::size_t frameIndex = capture.getNbFrames() - 1;
+    const float duration = capture.getFrameDurations().back();
+    ++m_nbFrames;
+
+    // complete the frames following the previous spikes
+    for (auto& spike : m_spikes)
+    {
+        if (spike.nbMissingFrames > 0)
+        {
+            spike.frames.addFrame(capture, frameIndex);
+            --spike.nbMissingFrames;
+        }
+    }
+
+    const float threshold = getThreshold();
+    m_recentDurations.push_back(duration);
+    if (!(duration > threshold))
+    {
+        return false;
+    }
+
+    const std::size_t nbContextFrames = static_cast<std::size_t>(std::max(0, m_settings.nbContextFrames));
+    const std::size_t firstFrameIndex = frameIndex >= nbContextFrames ? frameIndex - nbContextFrames : 0;
+
+    auto& spike = m_spikes.emplace_back();
+    spike.frameNumber = m_nbFrames;
+    spike.duration = duration;
+    spike.threshold = threshold;
+    spike.spikeFrameIndex = frameIndex - firstFrameIndex;
+    spike.nbMissingFrames = nbContextFrames;
+    spike.frames.setCapacity(2 * nbContextFrames + 1);
+    for (std::size_t i = firstFrameIndex; i <= frameIndex; ++i)
+    {
+        spike.frames.addFrame(capture, i);
+    }
+
+    while (m_spikes.size() > std::max<std::size_t>(1, m_settings.maxNbSpikes))
+    {
+        m_spikes.pop_front();
+    }
+    return true;
+}
+
+float SpikeCapture::getThreshold() const
+{
+    if (!m_settings.isRelative)
+    {
+        return m_settings.absoluteThreshold;
+    }
+
+    if (m_recentDurations.size() < minNbMedianFrames)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    m_sortedDurations.resize(m_recentDurations.size());
+    for (std::size_t i = 0; i < m_recentDurations.size(); ++i)
+    {
+        m_sortedDurations[i] = m_recentDurations[i];
+    }
+    const auto median = m_sortedDurations.begin() + static_cast<std::ptrdiff_t>(m_sortedDurations.size() / 2);
+    std::nth_element(m_sortedDurations.begin(), median, m_sortedDurations.end());
+    return m_settings.relativeThreshold * *median;
+}
+
+void SpikeCapture::removeSpike(const std::size_t spikeIndex)
+{
+    if (spikeIndex < m_spikes.size())
+    {
+        m_spikes.erase(m_spikes.begin() + static_cast<std::ptrdiff_t>(spikeIndex));
+    }
+}
+
+void SpikeCapture::clear()
+{
+    m_spikes.clear();
+    m_recentDurations.clear();
+    m_nbFrames = 0;
+}
+
+} // namespace sofaimgui
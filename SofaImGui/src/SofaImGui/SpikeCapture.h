@@ -0,0 +1,84 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+#include <SofaImGui/config.h>
+#include <SofaImGui/ProfilerCapture.h>
+#include <SofaImGui/RingBuffer.h>
+
+#include <deque>
+
+namespace sofaimgui
+{
+
+/**
+ * Detects the frames of a ProfilerCapture exceeding a time budget, and pins a copy of each of them
+ * with the frames around it, before they are overwritten in the rolling buffer of the capture.
+ *
+ * The budget is either an absolute duration, or a multiple of the median duration of the last
+ * frames.
+ */
+class SOFAIMGUI_API SpikeCapture
+{
+public:
+    struct Settings
+    {
+        bool isRelative { true };           ///< the threshold is a multiple of the running median
+        float absoluteThreshold { 33.f };   ///< ms
+        float relativeThreshold { 3.f };    ///< multiple of the median duration
+        int nbContextFrames { 5 };          ///< number of frames pinned before and after a spike
+        std::size_t maxNbSpikes { 32 };     ///< the oldest spikes are discarded first
+    };
+
+    struct Spike
+    {
+        std::size_t frameNumber {};     ///< number of the frame since the detection started
+        float duration {};              ///< ms
+        float threshold {};             ///< ms, at the time of the spike
+        std::size_t spikeFrameIndex {}; ///< index of the spike in the pinned frames
+        std::size_t nbMissingFrames {}; ///< frames after the spike not recorded yet
+        ProfilerCapture frames;
+    };
+
+    Settings& getSettings() { return m_settings; }
+
+    /// To call each time a frame is added to the capture. Returns true if the frame is a spike.
+    bool onFrameAdded(const ProfilerCapture& capture);
+
+    /// Threshold applied to the next frame (ms). Infinite while the running median is not known.
+    float getThreshold() const;
+
+    const std::deque<Spike>& getSpikes() const { return m_spikes; }
+    void removeSpike(std::size_t spikeIndex);
+    void clear();
+
+private:
+    /// Minimum number of frames to estimate the running median
+    static constexpr std::size_t minNbMedianFrames = 10;
+
+    Settings m_settings;
+    RingBuffer<float> m_recentDurations { 101 };
+    mutable std::vector<float> m_sortedDurations;
+    std::deque<Spike> m_spikes;
+    std::size_t m_nbFrames {};
+};
+
+} // namespace sofaimgui
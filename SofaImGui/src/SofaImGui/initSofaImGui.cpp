@@ -24,7 +24,8 @@
 #include <sofa/simulation/Node.h>
 #include <sofa/gui/common/GUIManager.h>
 #include <SofaImGui/ImGuiGUI.h>
-#include <sofa/helper/logging/LoggingMessageHandler.h>
+#include <SofaImGui/LogStore.h>
+#include <sofa/helper/logging/MessageDispatcher.h>
 
 namespace sofaimgui
 {
@@ -45,8 +46,7 @@ void initExternalModule()
     {
         first = false;
 
-        sofa::helper::logging::MessageDispatcher::addHandler(&sofa::helper::logging::MainLoggingMessageHandler::getInstance());
-        sofa::helper::logging::MainLoggingMessageHandler::getInstance().activate();
+        sofa::helper::logging::MessageDispatcher::addHandler(&sofaimgui::LogStore::getInstance());
 
         sofa::gui::common::GUIManager::RegisterGUI("imgui", &sofaimgui::ImGuiGUI::CreateGUI);
     }
@@ -51,7 +51,9 @@ namespace windows
                 groot->get(visualStyle);
                 if (visualStyle)
                 {
-                    auto& displayFlags = sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref();
+                    // the flags are modified only on user action: opening a write accessor every frame would
+                    // increment the counter of the Data, and the scene would be considered as changed
+                    const auto& displayFlags = visualStyle->displayFlags.getValue();
 
                     {
                         const bool initialValue = displayFlags.getShowVisualModels();
@@ -59,7 +61,7 @@ namespace windows
                         ImGui::Checkbox("Show Visual Models", &changeableValue);
                         if (changeableValue != initialValue)
                         {
-                            displayFlags.setShowVisualModels(changeableValue);
+                            sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref().setShowVisualModels(changeableValue);
                         }
                     }
 
@@ -69,7 +71,7 @@ namespace windows
                         ImGui::Checkbox("Show Behavior Models", &changeableValue);
                         if (changeableValue != initialValue)
                         {
-                            displayFlags.setShowBehaviorModels(changeableValue);
+                            sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref().setShowBehaviorModels(changeableValue);
                         }
                     }
 
@@ -79,7 +81,7 @@ namespace windows
                         ImGui::Checkbox("Show Force Fields", &changeableValue);
                         if (changeableValue != initialValue)
                         {
-                            displayFlags.setShowForceFields(changeableValue);
+                            sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref().setShowForceFields(changeableValue);
                         }
                     }
 
@@ -89,7 +91,7 @@ namespace windows
                         ImGui::Checkbox("Show Collision Models", &changeableValue);
                         if (changeableValue != initialValue)
                         {
-                            displayFlags.setShowCollisionModels(changeableValue);
+                            sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref().setShowCollisionModels(changeableValue);
                         }
                     }
 
@@ -99,7 +101,7 @@ namespace windows
                         ImGui::Checkbox("Show Bounding Collision Models", &changeableValue);
                         if (changeableValue != initialValue)
                         {
-                            displayFlags.setShowBoundingCollisionModels(changeableValue);
+                            sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref().setShowBoundingCollisionModels(changeableValue);
                         }
                     }
 
@@ -109,7 +111,7 @@ namespace windows
                         ImGui::Checkbox("Show Mappings", &changeableValue);
                         if (changeableValue != initialValue)
                         {
-                            displayFlags.setShowMappings(changeableValue);
+                            sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref().setShowMappings(changeableValue);
                         }
                     }
 
@@ -119,7 +121,7 @@ namespace windows
                         ImGui::Checkbox("Show Mechanical Mappings", &changeableValue);
                         if (changeableValue != initialValue)
                         {
-                            displayFlags.setShowMechanicalMappings(changeableValue);
+                            sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref().setShowMechanicalMappings(changeableValue);
                         }
                     }
 
@@ -129,7 +131,7 @@ namespace windows
                         ImGui::Checkbox("Show Wire Frame", &changeableValue);
                         if (changeableValue != initialValue)
                         {
-                            displayFlags.setShowWireFrame(changeableValue);
+                            sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref().setShowWireFrame(changeableValue);
                         }
                     }
 
@@ -139,7 +141,7 @@ namespace windows
                         ImGui::Checkbox("Show Normals", &changeableValue);
                         if (changeableValue != initialValue)
                         {
-                            displayFlags.setShowNormals(changeableValue);
+                            sofa::helper::getWriteAccessor(visualStyle->displayFlags).wref().setShowNormals(changeableValue);
                         }
                     }
 
@@ -22,8 +22,11 @@
 
 #include <SofaImGui/ImGuiGUIEngine.h>
 
-#include <iomanip>
-#include <sofa/helper/logging/LoggingMessageHandler.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <limits>
 #include <sofa/core/loader/SceneLoader.h>
 #include <sofa/simulation/SceneLoaderFactory.h>
 #include <sofa/simulation/Simulation.h>
@@ -36,13 +39,333 @@
 #include <sofa/component/visual/LineAxis.h>
 #include <sofa/gui/common/BaseGUI.h>
 #include <sofa/simulation/graph/DAGNode.h>
-#include <fstream>
+#include <sofa/helper/logging/Messaging.h>
+#include <SofaImGui/LogCache.h>
+#include <SofaImGui/LogStore.h>
+#include <SofaImGui/LogSearchIndex.h>
+#include <SofaGLFW/SofaGLFWLogFile.h>
 
 #include "Log.h"
 #include "WindowState.h"
 
 namespace windows
 {
+    namespace
+    {
+        /**
+         * Saving of the log in a file. The lines are formatted on the main thread, a few milliseconds per
+         * frame, and written by the background thread of the file.
+         */
+        struct LogExport
+        {
+            std::unique_ptr<sofaglfw::SofaGLFWLogFile> file;
+            std::size_t nbMessages {};
+            std::size_t nextMessage {};
+            bool isCancelled { false };
+            sofaimgui::LogStore::Entry entry;
+
+            bool isRunning() const { return file != nullptr; }
+
+            void start(const std::string& filename, const std::size_t nbMessagesToSave)
+            {
+                file = std::make_unique<sofaglfw::SofaGLFWLogFile>(filename);
+                if (!file->isOpen())
+                {
+                    file.reset();
+                    return;
+                }
+                nbMessages = nbMessagesToSave;
+                nextMessage = 0;
+                isCancelled = false;
+            }
+
+            /// Stops the export: the messages already handed to the file are written
+            void cancel()
+            {
+                nbMessages = nextMessage;
+                isCancelled = true;
+            }
+
+            void update(const sofaimgui::LogStore& store)
+            {
+                if (!file)
+                {
+                    return;
+                }
+
+                // the log may have been cleared since the beginning of the export
+                nbMessages = std::min(nbMessages, store.getNbMessages());
+
+                static constexpr std::size_t maxPendingLines = 100000;
+                static constexpr std::size_t batchSize = 256;
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(4);
+                while (nextMessage < nbMessages && file->getNbPendingLines() < maxPendingLines && std::chrono::steady_clock::now() < deadline)
+                {
+                    const std::size_t batchEnd = std::min(nbMessages, nextMessage + batchSize);
+                    for (; nextMessage < batchEnd && store.getEntry(nextMessage, entry); ++nextMessage)
+                    {
+                        file->write(sofaglfw::SofaGLFWLogFile::format(entry.type, entry.componentName, entry.componentPath, entry.text));
+                    }
+                }
+
+                if (nextMessage >= nbMessages)
+                {
+                    file->finish();
+                    if (file->isFinished())
+                    {
+                        if (file->hasFailed())
+                        {
+                            msg_error("Log") << "The log could not be saved completely in " << file->getFilename();
+                        }
+                        else if (isCancelled)
+                        {
+                            msg_info("Log") << "Export cancelled: only the first " << nbMessages << " messages are saved in " << file->getFilename();
+                        }
+                        else
+                        {
+                            msg_info("Log") << nbMessages << " messages saved in " << file->getFilename();
+                        }
+                        file.reset();
+                    }
+                }
+            }
+        };
+
+        /// Local time of a message, to the second
+        std::string formatTime(const sofaimgui::LogStore::Clock::time_point time)
+        {
+            const std::time_t t = sofaimgui::LogStore::Clock::to_time_t(time);
+            const std::tm* localTime = std::localtime(&t);
+            char buffer[16];
+            const std::size_t size = localTime ? std::strftime(buffer, sizeof(buffer), "%H:%M:%S", localTime) : 0;
+            return std::string(buffer, size);
+        }
+
+        /// Search in the messages of the log, and navigation through the hits
+        struct LogSearch
+        {
+            sofaimgui::LogSearchIndex index { sofaimgui::LogStore::getInstance() };
+            std::size_t nbIndexedRows {};
+
+            std::string hitsQuery;
+            std::vector<sofaimgui::LogSearchIndex::RowIndex> hits; ///< rows containing the query, in order
+            std::size_t nbMappedHits {};        ///< hits already located among the visible rows
+            std::vector<std::size_t> visibleHits; ///< the visible indices of the hits not filtered out
+            std::size_t revision { std::numeric_limits<std::size_t>::max() };
+            std::size_t searchRevision { std::numeric_limits<std::size_t>::max() };
+            std::size_t filterRevision { std::numeric_limits<std::size_t>::max() };
+            std::size_t currentHit {};          ///< in visibleHits
+            bool isScrollRequested { false };
+
+            /// Hands a new row of the log to the index
+            void feed(const std::size_t row, const std::string& text)
+            {
+                if (row < nbIndexedRows)
+                {
+                    // the log has been cleared
+                    index.clear();
+                }
+                index.add(text);
+                nbIndexedRows = row + 1;
+            }
+
+            /// Gets the new hits of the index, and locates them among the visible rows. All the hits are
+            /// located again only when the search or the filter changes.
+            void update(const sofaimgui::LogCache& logCache)
+            {
+                const std::size_t lastRevision = index.getRevision();
+                if (lastRevision == revision && logCache.getFilterRevision() == filterRevision)
+                {
+                    return;
+                }
+
+                if (lastRevision != revision)
+                {
+                    revision = lastRevision;
+                    const std::string previousQuery = hitsQuery;
+                    if (index.updateHits(searchRevision, hitsQuery, hits))
+                    {
+                        nbMappedHits = 0;
+                    }
+                    if (hitsQuery != previousQuery)
+                    {
+                        // a new search jumps to its first hit
+                        currentHit = 0;
+                        isScrollRequested = !hits.empty();
+                    }
+                }
+                if (logCache.getFilterRevision() != filterRevision)
+                {
+                    filterRevision = logCache.getFilterRevision();
+                    nbMappedHits = 0;
+                }
+
+                // the rows added to the log are appended to the visible rows: the visible indices of the
+                // hits already located do not change
+                if (nbMappedHits == 0)
+                {
+                    visibleHits.clear();
+                }
+                for (; nbMappedHits < hits.size(); ++nbMappedHits)
+                {
+                    const auto visibleIndex = logCache.findVisibleIndex(hits[nbMappedHits]);
+                    if (visibleIndex < logCache.getNbVisibleRows())
+                    {
+                        visibleHits.push_back(visibleIndex);
+                    }
+                }
+                currentHit = visibleHits.empty() ? 0 : std::min(currentHit, visibleHits.size() - 1);
+            }
+
+            bool isHit(const std::size_t row) const
+            {
+                return std::binary_search(hits.begin(), hits.end(), row);
+            }
+
+            bool isCurrentHit(const std::size_t visibleIndex) const
+            {
+                return currentHit < visibleHits.size() && visibleHits[currentHit] == visibleIndex;
+            }
+
+            void goToHit(const std::size_t hit)
+            {
+                if (!visibleHits.empty())
+                {
+                    currentHit = hit % visibleHits.size();
+                    isScrollRequested = true;
+                }
+            }
+        };
+
+        /// Search box, with the number of hits and the buttons to go through them. Returns true when going to a hit.
+        bool showSearch(LogSearch& search)
+        {
+            static char query[256] {};
+            ImGui::SetNextItemWidth(ImGui::CalcTextSize("A").x * 30.f);
+            const bool isEntered = ImGui::InputTextWithHint("##logSearch", ICON_FA_SEARCH "  Search", query, sizeof(query), ImGuiInputTextFlags_EnterReturnsTrue);
+            if (ImGui::IsItemEdited())
+            {
+                search.index.search(query);
+            }
+
+            const bool hasHits = !search.visibleHits.empty();
+            bool isGoingToHit = false;
+            ImGui::SameLine();
+            ImGui::BeginDisabled(!hasHits);
+            if (ImGui::Button(ICON_FA_CHEVRON_UP))
+            {
+                search.goToHit(search.currentHit + search.visibleHits.size() - 1);
+                isGoingToHit = true;
+            }
+            ImGui::SameLine();
+            if (ImGui::Button(ICON_FA_CHEVRON_DOWN) || (isEntered && hasHits))
+            {
+                search.goToHit(search.currentHit + 1);
+                isGoingToHit = true;
+            }
+            ImGui::EndDisabled();
+
+            ImGui::SameLine();
+            if (query[0] != '\0')
+            {
+                if (search.index.isBusy())
+                {
+                    ImGui::TextDisabled("Searching...");
+                }
+                else if (hasHits)
+                {
+                    ImGui::Text("%zu / %zu", search.currentHit + 1, search.visibleHits.size());
+                }
+                else
+                {
+                    ImGui::TextDisabled("No match");
+                }
+            }
+            ImGui::NewLine();
+            return isGoingToHit || search.isScrollRequested;
+        }
+
+        /// Toggles of the types of messages, with their number of messages, and selection of the sources
+        void showFilters(sofaimgui::LogCache& logCache)
+        {
+            using sofa::helper::logging::Message;
+            static constexpr std::array<std::pair<Message::Type, const char*>, 6> types {{
+                {Message::Info, "Info"}, {Message::Advice, "Suggestion"}, {Message::Deprecated, "Deprecated"},
+                {Message::Warning, "Warning"}, {Message::Error, "Error"}, {Message::Fatal, "Fatal"} }};
+
+            for (const auto& [type, name] : types)
+            {
+                bool isShown = logCache.isTypeShown(type);
+                const std::string label = std::string(name) + " (" + std::to_string(logCache.getNbMessages(type)) + ")";
+                if (ImGui::Checkbox(label.c_str(), &isShown))
+                {
+                    logCache.setTypeShown(type, isShown);
+                }
+                ImGui::SameLine();
+            }
+
+            const std::string sourcesLabel = logCache.getNbSelectedSources() > 0
+                ? "Sources (" + std::to_string(logCache.getNbSelectedSources()) + " selected)###sources"
+                : std::string("Sources###sources");
+            if (ImGui::Button(sourcesLabel.c_str()))
+            {
+                ImGui::OpenPopup("logSources");
+            }
+
+            if (ImGui::BeginPopup("logSources"))
+            {
+                const auto& sources = logCache.getSources();
+
+                static ImGuiTextFilter filter;
+                filter.Draw("Filter");
+                ImGui::SameLine();
+                if (ImGui::Button("Show all"))
+                {
+                    logCache.clearSourceSelection();
+                }
+
+                // the sources sorted by name, among the ones passing the filter
+                static std::vector<std::size_t> listedSources;
+                listedSources.clear();
+                for (std::size_t i = 0; i < sources.size(); ++i)
+                {
+                    if (!sources[i].rows.empty() && filter.PassFilter(sources[i].name.c_str()))
+                    {
+                        listedSources.push_back(i);
+                    }
+                }
+                std::sort(listedSources.begin(), listedSources.end(), [&sources](const std::size_t a, const std::size_t b)
+                {
+                    return sources[a].name < sources[b].name;
+                });
+
+                if (ImGui::BeginChild("logSourceList", ImVec2(ImGui::CalcTextSize("A").x * 60.f, ImGui::GetTextLineHeightWithSpacing() * 15.f)))
+                {
+                    ImGuiListClipper clipper;
+                    clipper.Begin(static_cast<int>(listedSources.size()));
+                    while (clipper.Step())
+                    {
+                        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+                        {
+                            const auto sourceId = listedSources[i];
+                            bool isSelected = logCache.isSourceSelected(sourceId);
+                            ImGui::PushID(static_cast<int>(sourceId));
+                            if (ImGui::Checkbox("##selected", &isSelected))
+                            {
+                                logCache.setSourceSelected(sourceId, isSelected);
+                            }
+                            ImGui::SameLine();
+                            ImGui::Text("%s (%zu)", sources[sourceId].name.c_str(), sources[sourceId].rows.size());
+                            ImGui::PopID();
+                        }
+                    }
+                }
+                ImGui::EndChild();
+                ImGui::EndPopup();
+            }
+        }
+    }
+
     void showLog(const char* const& windowNameLog,
                  WindowState& winManagerLog)
     {
@@ -51,87 +374,151 @@ namespace windows
         {
             if (ImGui::Begin(windowNameLog, winManagerLog.getStatePtr()))
             {
-                unsigned int i {};
-                const auto& messages = sofa::helper::logging::MainLoggingMessageHandler::getInstance().getMessages();
-                const int digits = [&messages]()
+                const auto& logStore = sofaimgui::LogStore::getInstance();
+
+                static sofaimgui::LogCache logCache;
+                static LogSearch search;
+                const bool hasNewRows = logCache.update(logStore, [](const std::size_t row, const sofaimgui::LogStore::Entry& entry)
+                {
+                    search.feed(row, entry.text);
+                });
+                search.update(logCache);
+
+                const int digits = []()
                 {
                     int d = 0;
-                    auto s = messages.size();
+                    auto s = logCache.getNbMessages();
                     while (s != 0) { s /= 10; d++; }
                     return d;
                 }();
 
                 static bool autoScroll{ true };
-                static bool showInfo{ true };
                 ImGui::Checkbox("AutoScroll", &autoScroll);
                 ImGui::SameLine();
-                ImGui::Checkbox("Show Info", &showInfo);
+                bool isCollapsed = logCache.isCollapsed();
+                if (ImGui::Checkbox("Collapse", &isCollapsed))
+                {
+                    logCache.setCollapsed(isCollapsed);
+                }
+                if (ImGui::IsItemHovered())
+                {
+                    ImGui::SetTooltip("Show the identical messages of a sender as a single row, with their number of repetitions");
+                }
                 ImGui::SameLine();
 
-                if (ImGui::Button(ICON_FA_SAVE" "))
+                static LogExport logExport;
+                logExport.update(logStore);
+                if (logExport.isRunning())
+                {
+                    const float progress = logExport.nbMessages > 0 ? static_cast<float>(logExport.file->getNbWrittenLines()) / static_cast<float>(logExport.nbMessages) : 1.f;
+                    const std::string label = "Saving " + std::to_string(logExport.file->getNbWrittenLines()) + " / " + std::to_string(logExport.nbMessages);
+                    ImGui::ProgressBar(progress, ImVec2(ImGui::CalcTextSize("A").x * 30.f, 0.f), label.c_str());
+                    ImGui::SameLine();
+                    if (ImGui::Button(ICON_FA_TIMES))
+                    {
+                        logExport.cancel();
+                    }
+                }
+                else if (ImGui::Button(ICON_FA_SAVE" "))
                 {
                     nfdchar_t *outPath;
                     const nfdresult_t result = NFD_SaveDialog(&outPath, nullptr, 0, nullptr, "log.txt");
                     if (result == NFD_OKAY)
                     {
-                        std::ofstream outputFile;
-                        outputFile.open(outPath, std::ios::out);
-
-                        if (outputFile.is_open())
-                        {
-                            for (const auto& message : messages)
-                            {
-                                static std::unordered_map<sofa::helper::logging::Message::Type, std::string> labelMap {
-                                        {sofa::helper::logging::Message::Advice, "SUGGESTION"},
-                                        {sofa::helper::logging::Message::Deprecated, "DEPRECATED"},
-                                        {sofa::helper::logging::Message::Warning, "WARNING"},
-                                        {sofa::helper::logging::Message::Info, "INFO"},
-                                        {sofa::helper::logging::Message::Error, "ERROR"},
-                                        {sofa::helper::logging::Message::Fatal, "FATAL"},
-                                        {sofa::helper::logging::Message::TEmpty, "EMPTY"},
-                                };
-                                outputFile << "[" << labelMap[message.type()] << "]";
-                                if (const auto* nfo = dynamic_cast<sofa::helper::logging::SofaComponentInfo*>(message.componentInfo().get()))
-                                {
-                                    outputFile << " " << nfo->name();
-                                    if (nfo->m_component)
-                                    {
-                                        outputFile << " (" << nfo->m_component->getPathName() << ")";
-                                    }
-                                }
-                                outputFile << " " << message.messageAsString() << std::endl;
-                            }
-                            outputFile.close();
-                        } else
-                        {
-                            std::cout << "Failed to open the file " << outPath << std::endl;
-                        }
+                        logExport.start(outPath, logStore.getNbMessages());
                         NFD_FreePath(outPath);
                     }
                 }
 
-                std::size_t nbRows = 0;
-                if (ImGui::BeginTable("logTable", 4, ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollY))
+                showFilters(logCache);
+                if (showSearch(search))
+                {
+                    // going to a hit would be undone by the automatic scrolling
+                    autoScroll = false;
+                }
+
+                static constexpr ImGuiTableFlags flags = ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersInnerV;
+                if (ImGui::BeginTable("logTable", 5, flags))
                 {
-                    ImGui::TableSetupColumn("logId", ImGuiTableColumnFlags_WidthFixed);
-                    ImGui::TableSetupColumn("message type", ImGuiTableColumnFlags_WidthFixed);
-                    ImGui::TableSetupColumn("sender", ImGuiTableColumnFlags_WidthFixed);
+                    // fixed widths: fitting the columns to the visible rows would change the wrapping of the
+                    // messages, and the heights of all the rows, while scrolling
+                    // the index of the message, or the number of repetitions of a collapsed row
+                    ImGui::TableSetupColumn("logId", ImGuiTableColumnFlags_WidthFixed, ImGui::CalcTextSize("0").x * static_cast<float>(std::max(digits, 1) + 1));
+                    ImGui::TableSetupColumn("time", ImGuiTableColumnFlags_WidthFixed, ImGui::CalcTextSize("00:00:00 - 00:00:00").x);
+                    ImGui::TableSetupColumn("message type", ImGuiTableColumnFlags_WidthFixed, ImGui::CalcTextSize("[SUGGESTION]").x);
+                    ImGui::TableSetupColumn("sender", ImGuiTableColumnFlags_WidthFixed, ImGui::CalcTextSize("A").x * 30.f);
                     ImGui::TableSetupColumn("message", ImGuiTableColumnFlags_WidthStretch);
-                    for (const auto& message : messages)
+
+                    const std::size_t nbRows = logCache.getNbVisibleRows();
+                    if (search.isScrollRequested && search.currentHit < search.visibleHits.size())
+                    {
+                        ImGui::SetScrollY(std::max(0.f, logCache.getRowTop(search.visibleHits[search.currentHit]) - ImGui::GetWindowHeight() * 0.3f));
+                        search.isScrollRequested = false;
+                    }
+                    const float scrollY = ImGui::GetScrollY();
+                    const std::size_t firstRow = logCache.findVisibleRow(scrollY);
+                    const std::size_t lastRow = std::min(nbRows, logCache.findVisibleRow(scrollY + ImGui::GetWindowHeight()) + 1);
+
+                    // the first row gives the width of the message column, in which the messages are wrapped
+                    ImGui::TableNextRow(ImGuiTableRowFlags_None, nbRows > 0 ? logCache.getRowTop(firstRow) : 0.f);
+                    ImGui::TableSetColumnIndex(4);
+                    logCache.setLayout(ImGui::GetContentRegionAvail().x, ImGui::GetTextLineHeight(), 2.f * ImGui::GetStyle().CellPadding.y);
+
+                    // the content of the visible rows is read from the store, from the file for the oldest messages
+                    sofaimgui::LogStore::Entry entry;
+                    sofaimgui::LogStore::Entry lastEntry;
+                    for (std::size_t row = firstRow; row < lastRow; ++row)
                     {
-                        if (!showInfo && message.type() == sofa::helper::logging::Message::Info)
+                        const auto& logRow = logCache.getVisibleRow(row);
+                        const std::size_t messageIndex = logCache.getVisibleRowIndex(row);
+                        logStore.getEntry(messageIndex, entry);
+
+                        ImGui::TableNextRow(ImGuiTableRowFlags_None, logCache.measureRowHeight(row, entry.text));
+                        if (search.isHit(messageIndex))
                         {
-                            continue;
+                            const ImVec4 color = ImGui::GetStyleColorVec4(ImGuiCol_TextSelectedBg);
+                            ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, ImGui::GetColorU32(search.isCurrentHit(row) ? ImVec4(color.x, color.y, color.z, 1.f) : color));
                         }
 
-                        ImGui::TableNextRow();
-                        nbRows++;
+                        const auto* group = logCache.findGroup(messageIndex);
+                        const bool isRepeated = group && group->count > 1;
+                        if (isRepeated)
+                        {
+                            logStore.getEntry(group->last, lastEntry);
+                        }
 
                         ImGui::TableNextColumn();
+                        if (isRepeated)
+                        {
+                            ImGui::Text("x%u", group->count);
+                            if (ImGui::IsItemHovered())
+                            {
+                                ImGui::SetTooltip("Repeated %u times\nFirst: %0*zu\nLast: %0*zu", group->count, digits, messageIndex, digits, static_cast<std::size_t>(group->last));
+                            }
+                        }
+                        else
+                        {
+                            ImGui::Text("%0*zu", digits, messageIndex);
+                        }
 
-                        std::stringstream ss;
-                        ss << std::setfill('0') << std::setw(digits) << i++;
-                        ImGui::Text(ss.str().c_str());
+                        ImGui::TableNextColumn();
+                        if (isRepeated)
+                        {
+                            ImGui::Text("%s - %s", formatTime(entry.time).c_str(), formatTime(lastEntry.time).c_str());
+                        }
+                        else
+                        {
+                            ImGui::TextUnformatted(formatTime(entry.time).c_str());
+                            if (entry.nbDroppedBefore > 0)
+                            {
+                                ImGui::SameLine();
+                                ImGui::TextColored(ImVec4(1.f, 0.4275f, 0.f, 1.f), "+%u", entry.nbDroppedBefore);
+                                if (ImGui::IsItemHovered())
+                                {
+                                    ImGui::SetTooltip("%u messages of this sender have been dropped by the rate limit before this one", entry.nbDroppedBefore);
+                                }
+                            }
+                        }
 
                         ImGui::TableNextColumn();
 
@@ -149,33 +536,51 @@ namespace windows
                                 default: return;
                             }
                         };
-                        writeMessageType(message.type());
+                        writeMessageType(logRow.getType());
 
-                        auto sender = message.sender();
-                        auto* nfo = dynamic_cast<sofa::helper::logging::SofaComponentInfo*>(message.componentInfo().get());
-                        if (nfo)
+                        ImGui::TableNextColumn();
+                        if (!entry.componentName.empty())
                         {
-                            sender.append("(" + nfo->name() + ")");
+                            entry.sender.append("(" + entry.componentName + ")");
                         }
+                        ImGui::TextUnformatted(entry.sender.c_str(), entry.sender.c_str() + entry.sender.size());
 
-                        ImGui::TableNextColumn();
-                        ImGui::Text(sender.c_str());
-
-                        if (nfo && ImGui::IsItemHovered() && nfo->m_component)
+                        if (!entry.componentPath.empty() && ImGui::IsItemHovered())
                         {
-                            ImGui::SetTooltip("Path: %s", nfo->m_component->getPathName().c_str());
+                            ImGui::SetTooltip("Path: %s", entry.componentPath.c_str());
                         }
+                        ImGui::PushID(static_cast<int>(messageIndex));
+                        if (ImGui::BeginPopupContextItem("sourceMenu"))
+                        {
+                            if (ImGui::MenuItem("Show only this source"))
+                            {
+                                logCache.clearSourceSelection();
+                                logCache.setSourceSelected(logRow.sourceId, true);
+                            }
+                            if (ImGui::MenuItem("Show all the sources", nullptr, false, logCache.getNbSelectedSources() > 0))
+                            {
+                                logCache.clearSourceSelection();
+                            }
+                            ImGui::EndPopup();
+                        }
+                        ImGui::PopID();
 
                         ImGui::TableNextColumn();
-                        ImGui::TextWrapped(message.message().str().c_str());
+                        ImGui::PushTextWrapPos(0.f);
+                        ImGui::TextUnformatted(entry.text.c_str(), entry.text.c_str() + entry.text.size());
+                        ImGui::PopTextWrapPos();
+                    }
+
+                    // the rows after the visible ones only take their space
+                    if (lastRow < nbRows)
+                    {
+                        ImGui::TableNextRow(ImGuiTableRowFlags_None, logCache.getTotalHeight() - logCache.getRowTop(lastRow));
                     }
 
-                    static std::size_t lastNbRows = 0;
-                    if (autoScroll && lastNbRows < nbRows)
+                    if (autoScroll && hasNewRows)
                     {
-                        ImGui::SetScrollHereY(1.0f);
+                        ImGui::SetScrollY(logCache.getTotalHeight());
                     }
-                    lastNbRows = nbRows;
 
                     ImGui::EndTable();
                 }
@@ -38,7 +38,7 @@ namespace windows
         /**
          * @brief Shows the Log window.
          *
-         * This function displays a window containing log messages. It provides options to filter messages by type and save the log to a file. The displayed log messages include their IDs, types, senders, and the messages themselves.
+         * This function displays a window containing log messages. Only the rows visible in the window are drawn, from messages formatted once when they are logged. It provides options to filter messages by type and by source (component or sender), showing the number of messages of each, to search a text in the messages and go through the matching ones, and to save the log to a file. The displayed log messages include their IDs, types, senders, and the messages themselves.
          *
          * @param windowNameLog The name of the Log window.
          * @param isLogWindowOpen A reference to a boolean flag indicating if the Log window is open.
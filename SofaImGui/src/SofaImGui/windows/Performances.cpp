@@ -23,18 +23,273 @@
 #include <imgui.h>
 #include <imgui_internal.h> //imgui_internal.h is included in order to use the DockspaceBuilder API (which is still in development)
 #include <sofa/type/vector.h>
+#include <SofaGLFW/SofaGLFWAllocationTracker.h>
+#include <SofaGLFW/SofaGLFWFrameStages.h>
+#include <SofaImGui/RingBuffer.h>
+#include <implot.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
 
 
 namespace windows
 {
 
+    namespace
+    {
+        using sofaglfw::SofaGLFWAllocationTracker;
+        using sofaglfw::SofaGLFWFrameStages;
+
+        /// Durations of the last frames, in milliseconds, per stage of the main loop
+        struct FrameHistory
+        {
+            static constexpr std::size_t capacity = 2000;
+            /// the stages, then the time spent outside of the stages
+            static constexpr std::size_t nbSeries = SofaGLFWFrameStages::nbStages + 1;
+
+            std::array<sofaimgui::RingBuffer<float>, nbSeries> durations;
+            /// sum of the durations of the series up to i: the last one is the duration of the frame
+            std::array<sofaimgui::RingBuffer<float>, nbSeries> stackTops;
+            std::uint64_t nbCompletedFrames {};
+
+            FrameHistory()
+            {
+                for (std::size_t i = 0; i < nbSeries; ++i)
+                {
+                    durations[i].setCapacity(capacity);
+                    stackTops[i].setCapacity(capacity);
+                }
+            }
+
+            static const char* getName(const std::size_t series)
+            {
+                return series < SofaGLFWFrameStages::nbStages ? SofaGLFWFrameStages::getName(static_cast<SofaGLFWFrameStages::Stage>(series)) : "Other";
+            }
+
+            const sofaimgui::RingBuffer<float>& frameDurations() const { return stackTops.back(); }
+
+            void update()
+            {
+                const auto nbFrames = SofaGLFWFrameStages::getNbCompletedFrames();
+                if (nbFrames == nbCompletedFrames)
+                {
+                    return;
+                }
+                nbCompletedFrames = nbFrames;
+
+                const auto& frame = SofaGLFWFrameStages::getLastFrame();
+                float top = 0.f;
+                for (std::size_t i = 0; i < SofaGLFWFrameStages::nbStages; ++i)
+                {
+                    const float duration = std::max(0.f, frame.stages[i]);
+                    durations[i].push_back(duration);
+                    top += duration;
+                    stackTops[i].push_back(top);
+                }
+                durations.back().push_back(std::max(0.f, frame.total - top));
+                stackTops.back().push_back(std::max(frame.total, top));
+            }
+        };
+
+        struct Percentiles
+        {
+            float mean {};
+            float p50 {};
+            float p90 {};
+            float p99 {};
+            float max {};
+        };
+
+        Percentiles computePercentiles(const sofaimgui::RingBuffer<float>& values, std::vector<float>& sorted)
+        {
+            if (values.empty())
+            {
+                return {};
+            }
+            sorted.assign(values.data(), values.data() + values.size()); // the order of the elements does not matter
+            std::sort(sorted.begin(), sorted.end());
+            const auto at = [&sorted](const float q)
+            {
+                return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(q * static_cast<float>(sorted.size())))];
+            };
+            const float mean = std::accumulate(sorted.begin(), sorted.end(), 0.f) / static_cast<float>(sorted.size());
+            return { mean, at(0.5f), at(0.9f), at(0.99f), sorted.back() };
+        }
+
+        /**
+         * Shows the durations of the stages of the last frames: stacked over time, their percentiles, and the
+         * distribution of the frame durations.
+         */
+        void showFrameStages(const FrameHistory& history)
+        {
+            const auto& frames = history.frameDurations();
+            if (frames.empty())
+            {
+                return;
+            }
+
+            // sorting all the series every frame would cost more than what is displayed
+            static std::array<Percentiles, FrameHistory::nbSeries + 1> percentiles;
+            static double lastUpdateTime = -1.;
+            if (ImGui::GetTime() - lastUpdateTime > 0.5)
+            {
+                lastUpdateTime = ImGui::GetTime();
+                static std::vector<float> sorted;
+                for (std::size_t i = 0; i < FrameHistory::nbSeries; ++i)
+                {
+                    percentiles[i] = computePercentiles(history.durations[i], sorted);
+                }
+                percentiles.back() = computePercentiles(frames, sorted);
+            }
+
+            const auto& framePercentiles = percentiles.back();
+            ImGui::Text("Last %zu frames: average %.3f ms/frame (%.1f FPS), 99%% of the frames under %.3f ms",
+                        frames.size(), framePercentiles.mean, framePercentiles.mean > 0.f ? 1000.f / framePercentiles.mean : 0.f, framePercentiles.p99);
+
+            if (ImPlot::BeginPlot("Frame stages", ImVec2(-1, 200)))
+            {
+                ImPlot::SetupAxes(nullptr, "ms", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+                // the series are stacked by drawing the highest first, each one hiding the lower part of the previous
+                for (std::size_t i = FrameHistory::nbSeries; i-- > 0;)
+                {
+                    const auto& tops = history.stackTops[i];
+                    ImPlot::SetNextFillStyle(IMPLOT_AUTO_COL, 1.f);
+                    ImPlot::PlotShaded(FrameHistory::getName(i), tops.data(), tops.size(), 0.);
+                }
+                ImPlot::EndPlot();
+            }
+
+            static constexpr ImGuiTableFlags flags = ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_RowBg;
+            if (ImGui::BeginTable("framePercentiles", 6, flags))
+            {
+                ImGui::TableSetupColumn("Stage (ms)");
+                ImGui::TableSetupColumn("Mean");
+                ImGui::TableSetupColumn("Median");
+                ImGui::TableSetupColumn("90%");
+                ImGui::TableSetupColumn("99%");
+                ImGui::TableSetupColumn("Max");
+                ImGui::TableHeadersRow();
+                for (std::size_t i = 0; i < percentiles.size(); ++i)
+                {
+                    const auto& p = percentiles[i];
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(i < FrameHistory::nbSeries ? FrameHistory::getName(i) : "Frame");
+                    for (const float value : { p.mean, p.p50, p.p90, p.p99, p.max })
+                    {
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.3f", value);
+                    }
+                }
+                ImGui::EndTable();
+            }
+
+            if (ImPlot::BeginPlot("Distribution of the frame durations", ImVec2(-1, 150)))
+            {
+                ImPlot::SetupAxes("ms", "Frames", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+                ImPlot::PlotHistogram("Frames", frames.data(), static_cast<int>(frames.size()), ImPlotBin_Sturges);
+                ImPlot::EndPlot();
+            }
+        }
+
+        /// Counters of the last completed scopes of a kind (simulation steps or GUI frames)
+        struct AllocationHistory
+        {
+            static constexpr std::size_t capacity = 2000;
+
+            sofaimgui::RingBuffer<float> nbAllocations { capacity };
+            sofaimgui::RingBuffer<float> peakLiveKB { capacity };
+            std::uint64_t nbCompletedScopes {};
+            std::size_t nbScopesWithAllocations {}; ///< among the ones in the history
+
+            void update(const SofaGLFWAllocationTracker::Scope scope)
+            {
+                const auto nbScopes = SofaGLFWAllocationTracker::getNbCompletedScopes(scope);
+                if (nbScopes == nbCompletedScopes)
+                {
+                    return;
+                }
+                nbCompletedScopes = nbScopes;
+
+                if (nbAllocations.full() && nbAllocations.front() > 0.f)
+                {
+                    --nbScopesWithAllocations;
+                }
+                const auto counters = SofaGLFWAllocationTracker::getLastCounters(scope);
+                nbAllocations.push_back(static_cast<float>(counters.nbAllocations));
+                peakLiveKB.push_back(static_cast<float>(counters.peakLiveBytes) / 1024.f);
+                if (counters.nbAllocations > 0)
+                {
+                    ++nbScopesWithAllocations;
+                }
+            }
+        };
+
+        void showCounters(const char* name, const SofaGLFWAllocationTracker::Scope scope, const AllocationHistory& history)
+        {
+            const auto counters = SofaGLFWAllocationTracker::getLastCounters(scope);
+            ImGui::Text("Last %s: %llu allocations (%.1f KB), %llu deallocations (%.1f KB), peak live %.1f KB", name,
+                        static_cast<unsigned long long>(counters.nbAllocations), static_cast<double>(counters.allocatedBytes) / 1024.,
+                        static_cast<unsigned long long>(counters.nbDeallocations), static_cast<double>(counters.freedBytes) / 1024.,
+                        static_cast<double>(counters.peakLiveBytes) / 1024.);
+            ImGui::Text("  %zu of the last %zu %ss allocated", history.nbScopesWithAllocations, history.nbAllocations.size(), name);
+        }
+
+        /**
+         * Shows the allocations of the main thread during the simulation steps and during the GUI frames.
+         * In steady state, a step should not allocate.
+         */
+        void showAllocations()
+        {
+            if (!SofaGLFWAllocationTracker::isAvailable())
+            {
+                ImGui::TextDisabled("Build SofaGLFW with SOFAGLFW_ENABLE_ALLOCATION_TRACKER to track the allocations");
+                return;
+            }
+
+            bool isEnabled = SofaGLFWAllocationTracker::isEnabled();
+            if (ImGui::Checkbox("Track allocations", &isEnabled))
+            {
+                SofaGLFWAllocationTracker::setEnabled(isEnabled);
+            }
+            if (!isEnabled)
+            {
+                return;
+            }
+
+            static AllocationHistory stepHistory;
+            static AllocationHistory frameHistory;
+            stepHistory.update(SofaGLFWAllocationTracker::Scope::Step);
+            frameHistory.update(SofaGLFWAllocationTracker::Scope::Frame);
+
+            showCounters("step", SofaGLFWAllocationTracker::Scope::Step, stepHistory);
+            showCounters("frame", SofaGLFWAllocationTracker::Scope::Frame, frameHistory);
+
+            const auto plotHistories = [](const char* plotName, const char* yLabel,
+                                          const sofaimgui::RingBuffer<float>& steps, const sofaimgui::RingBuffer<float>& frames)
+            {
+                if (ImPlot::BeginPlot(plotName, ImVec2(-1, 150)))
+                {
+                    ImPlot::SetupAxes(nullptr, yLabel, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+                    ImPlot::PlotLine("Steps", steps.data(), steps.size());
+                    ImPlot::PlotLine("Frames", frames.data(), frames.size());
+                    ImPlot::EndPlot();
+                }
+            };
+            plotHistories("Number of allocations", "Allocations", stepHistory.nbAllocations, frameHistory.nbAllocations);
+            plotHistories("Peak live memory", "KB", stepHistory.peakLiveKB, frameHistory.peakLiveKB);
+        }
+    }
+
 
     void showPerformances(const char *const &windowNamePerformances,
                           const ImGuiIO &io,
                           WindowState& winManagerPerformances)
     {
         if (*winManagerPerformances.getStatePtr()) {
-            static sofa::type::vector<float> msArray;
+            static FrameHistory frameHistory;
+            frameHistory.update();
             if (ImGui::Begin(windowNamePerformances, winManagerPerformances.getStatePtr())) {
                 ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
                 ImGui::Text("%d vertices, %d indices (%d triangles)", io.MetricsRenderVertices, io.MetricsRenderIndices,
@@ -42,12 +297,12 @@ namespace windows
                 ImGui::Text("%d visible windows, %d active allocations", io.MetricsRenderWindows,
                             io.MetricsActiveAllocations);
 
-                msArray.push_back(1000.0f / io.Framerate);
-                if (msArray.size() >= 2000) {
-                    msArray.erase(msArray.begin());
+                showFrameStages(frameHistory);
+
+                if (ImGui::CollapsingHeader("Allocations"))
+                {
+                    showAllocations();
                 }
-                ImGui::PlotLines("Frame Times", msArray.data(), msArray.size(), 0, nullptr, FLT_MAX, FLT_MAX,
-                                 ImVec2(0, 100));
             }
             ImGui::End();
         }
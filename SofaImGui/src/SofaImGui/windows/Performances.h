@@ -40,7 +40,7 @@ namespace windows
         /**
          * @brief Shows the Performance window.
          *
-         * This function displays performance metrics including the average frame time, frames per second (FPS), number of vertices, indices, triangles, visible windows, and active allocations. It also plots the frame times over a certain period.
+         * This function displays performance metrics including the average frame time, frames per second (FPS), number of vertices, indices, triangles, visible windows, and active allocations. It also shows the durations of the stages of the last frames (events, simulation step, visual update, scene drawing, UI building and rendering, buffer swap), their percentiles and the distribution of the frame durations.
          *
          * @param windowNamePerformances The name of the Performance window.
          * @param io The ImGuiIO structure containing ImGui's I/O configuration settings.
@@ -24,6 +24,13 @@
 #include <sofa/type/vector.h>
 #include <SofaImGui/ImGuiGUIEngine.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <sofa/core/loader/SceneLoader.h>
@@ -35,6 +42,7 @@
 #include <sofa/helper/AdvancedTimer.h>
 
 #include <implot.h>
+#include <nfd.h>
 
 #include <IconsFontAwesome5.h>
 
@@ -47,104 +55,771 @@
 #include <sofa/gui/common/BaseGUI.h>
 
 #include <sofa/simulation/graph/DAGNode.h>
+#include <SofaImGui/ProfilerCapture.h>
+#include <SofaImGui/SpikeCapture.h>
 #include "Profiler.h"
 
 
 namespace windows {
 
-    void showProfiler(sofa::core::sptr<sofa::simulation::Node> groot
-            , const char* const& windowNameProfiler
-            , WindowState& winManagerProfiler)
+    namespace
     {
-        if (*winManagerProfiler.getStatePtr())
+        /**
+         * Statistics of the capture, shared by the views showing them: computing them scans all the
+         * buffered records, so they are recomputed at most twice per second, whatever the number of views.
+         */
+        struct SharedStatistics
         {
-            static int selectedFrame = 0;
+            sofaimgui::ProfilerCapture::Statistics statistics;
+            std::size_t captureRevision = std::numeric_limits<std::size_t>::max();
+            std::size_t revision {}; ///< incremented each time the statistics are recomputed
+            double lastUpdateTime {};
 
-            if (ImGui::Begin(windowNameProfiler, winManagerProfiler.getStatePtr()))
+            void update(const sofaimgui::ProfilerCapture& capture)
             {
-                const auto convertInMs = [](sofa::helper::system::thread::ctime_t t)
+                if (captureRevision != capture.getRevision() && ImGui::GetTime() - lastUpdateTime > 0.5)
                 {
-                    static auto timer_freqd = static_cast<SReal>(sofa::helper::system::thread::CTime::getTicksPerSec());
-                    return 1000.0 * static_cast<SReal>(t) / static_cast<SReal>(timer_freqd);
-                };
+                    capture.computeStatistics(statistics);
+                    captureRevision = capture.getRevision();
+                    lastUpdateTime = ImGui::GetTime();
+                    ++revision;
+                }
+            }
+        };
 
-                static std::deque< sofa::type::vector<sofa::helper::Record> > allRecords;
-                static int bufferSize = 500;
-                ImGui::SliderInt("Buffer size", &bufferSize, 10, 5000);
-                selectedFrame = std::min(selectedFrame, bufferSize - 1);
+        SharedStatistics& getSharedStatistics(const sofaimgui::ProfilerCapture& capture)
+        {
+            static SharedStatistics sharedStatistics;
+            sharedStatistics.update(capture);
+            return sharedStatistics;
+        }
 
-                static bool showChart = true;
-                ImGui::Checkbox("Show Chart", &showChart);
+        /**
+         * Shows the statistics of all the buffered frames: a sortable table of the timers, and the call
+         * tree averaged over the frames.
+         */
+        void showStatistics(const sofaimgui::ProfilerCapture& capture)
+        {
+            auto& sharedStatistics = getSharedStatistics(capture);
+            auto& statistics = sharedStatistics.statistics;
+            static std::size_t statisticsRevision = std::numeric_limits<std::size_t>::max();
 
-                if (groot->animate_.getValue())
-                {
-                    sofa::type::vector<sofa::helper::Record> _records = sofa::helper::AdvancedTimer::getRecords("Animate");
-                    allRecords.emplace_back(std::move(_records));
+            const bool isSortNeeded = statisticsRevision != sharedStatistics.revision;
+            statisticsRevision = sharedStatistics.revision;
 
-                    while (allRecords.size() >= bufferSize)
+            if (statistics.nbFrames == 0)
+            {
+                ImGui::TextDisabled("No frame recorded");
+                return;
+            }
+            ImGui::Text("%zu frames, average step duration (ms): %f", statistics.nbFrames, statistics.totalFrameDuration / statistics.nbFrames);
+
+            if (ImGui::BeginTabBar("profilerStatistics"))
+            {
+                const float columnWidth = ImGui::CalcTextSize("A").x * 10.0f;
+                const ImVec2 outerSize(0.f, ImGui::GetTextLineHeightWithSpacing() * 15);
+
+                if (ImGui::BeginTabItem("Hotspots"))
+                {
+                    static constexpr ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg;
+                    if (ImGui::BeginTable("profilerHotspots", 8, flags, outerSize))
                     {
-                        allRecords.pop_front();
+                        ImGui::TableSetupScrollFreeze(0, 1);
+                        ImGui::TableSetupColumn("Label", ImGuiTableColumnFlags_NoHide);
+                        ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                        ImGui::TableSetupColumn("Total (ms)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                        ImGui::TableSetupColumn("Mean (ms)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                        ImGui::TableSetupColumn("Min (ms)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                        ImGui::TableSetupColumn("Max (ms)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                        ImGui::TableSetupColumn("p95 (ms)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                        ImGui::TableSetupColumn("Share (%)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending | ImGuiTableColumnFlags_DefaultSort, columnWidth);
+                        ImGui::TableHeadersRow();
+
+                        if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs())
+                        {
+                            if ((sortSpecs->SpecsDirty || isSortNeeded) && sortSpecs->SpecsCount > 0)
+                            {
+                                const auto& spec = sortSpecs->Specs[0];
+                                const auto key = [&capture, column = spec.ColumnIndex](const sofaimgui::ProfilerCapture::TimerStatistics& timer) -> double
+                                {
+                                    switch (column)
+                                    {
+                                        case 1: return static_cast<double>(timer.nbCalls);
+                                        case 2: return timer.total;
+                                        case 3: return timer.mean;
+                                        case 4: return timer.min;
+                                        case 5: return timer.max;
+                                        case 6: return timer.p95;
+                                        default: return timer.share;
+                                    }
+                                };
+                                const bool isAscending = spec.SortDirection == ImGuiSortDirection_Ascending;
+                                std::sort(statistics.timers.begin(), statistics.timers.end(),
+                                    [&](const auto& a, const auto& b)
+                                    {
+                                        if (spec.ColumnIndex == 0)
+                                        {
+                                            const auto comparison = capture.getLabel(a.labelId).compare(capture.getLabel(b.labelId));
+                                            return isAscending ? comparison < 0 : comparison > 0;
+                                        }
+                                        return isAscending ? key(a) < key(b) : key(a) > key(b);
+                                    });
+                                sortSpecs->SpecsDirty = false;
+                            }
+                        }
+
+                        for (const auto& timer : statistics.timers)
+                        {
+                            ImGui::TableNextRow();
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%s", capture.getLabel(timer.labelId).c_str());
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%zu", timer.nbCalls);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.3f", timer.total);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.3f", timer.mean);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.3f", timer.min);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.3f", timer.max);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.3f", timer.p95);
+                            ImGui::TableNextColumn();
+                            ImGui::Text("%.2f", 100. * timer.share);
+                        }
+                        ImGui::EndTable();
                     }
+                    ImGui::EndTabItem();
                 }
 
-                static std::unordered_set<int> selectedTimers;
-
-                struct Chart
+                if (ImGui::BeginTabItem("Call tree"))
                 {
-                    std::string label;
-                    sofa::type::vector<float> values;
-                };
+                    static constexpr ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_NoBordersInBody;
+                    if (ImGui::BeginTable("profilerCallTree", 5, flags, outerSize))
+                    {
+                        ImGui::TableSetupScrollFreeze(0, 1);
+                        ImGui::TableSetupColumn("Label", ImGuiTableColumnFlags_NoHide);
+                        ImGui::TableSetupColumn("Per step (ms)", ImGuiTableColumnFlags_WidthFixed, columnWidth);
+                        ImGui::TableSetupColumn("Per call (ms)", ImGuiTableColumnFlags_WidthFixed, columnWidth);
+                        ImGui::TableSetupColumn("Calls per step", ImGuiTableColumnFlags_WidthFixed, columnWidth);
+                        ImGui::TableSetupColumn("Share (%)", ImGuiTableColumnFlags_WidthFixed, columnWidth);
+                        ImGui::TableHeadersRow();
+
+                        const double nbFrames = static_cast<double>(statistics.nbFrames);
+                        std::function<void(std::size_t)> showNode;
+                        showNode = [&](const std::size_t nodeIndex)
+                        {
+                            // the most expensive children first
+                            std::vector<std::size_t> children;
+                            children.reserve(statistics.callTree[nodeIndex].children.size());
+                            for (const auto& [labelId, childIndex] : statistics.callTree[nodeIndex].children)
+                            {
+                                children.push_back(childIndex);
+                            }
+                            std::sort(children.begin(), children.end(), [&statistics = statistics](const std::size_t a, const std::size_t b)
+                            {
+                                return statistics.callTree[a].total > statistics.callTree[b].total;
+                            });
+
+                            for (const auto childIndex : children)
+                            {
+                                const auto& node = statistics.callTree[childIndex];
+                                ImGui::TableNextRow();
+                                ImGui::TableNextColumn();
+                                ImGuiTreeNodeFlags nodeFlags = ImGuiTreeNodeFlags_SpanFullWidth;
+                                if (node.children.empty())
+                                {
+                                    nodeFlags |= ImGuiTreeNodeFlags_Leaf;
+                                }
+                                ImGui::PushID(static_cast<int>(childIndex));
+                                const bool isOpen = ImGui::TreeNodeEx(capture.getLabel(node.labelId).c_str(), nodeFlags);
+                                ImGui::PopID();
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%.3f", node.total / nbFrames);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%.3f", node.total / static_cast<double>(node.nbCalls));
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%.2f", static_cast<double>(node.nbCalls) / nbFrames);
+                                ImGui::TableNextColumn();
+                                ImGui::Text("%.2f", statistics.totalFrameDuration > 0. ? 100. * node.total / statistics.totalFrameDuration : 0.);
+                                if (isOpen)
+                                {
+                                    showNode(childIndex);
+                                    ImGui::TreePop();
+                                }
+                            }
+                        };
+                        showNode(0);
+
+                        ImGui::EndTable();
+                    }
+                    ImGui::EndTabItem();
+                }
+                ImGui::EndTabBar();
+            }
+        }
 
-                sofa::type::vector<float> frameChart;
-                frameChart.reserve(allRecords.size());
+        /// Comparison of a timer between the baseline and the current capture. The values missing in a capture are NaN.
+        struct TimerComparison
+        {
+            std::string label;
+            double baselineMean { std::numeric_limits<double>::quiet_NaN() }; ///< per step, ms
+            double currentMean { std::numeric_limits<double>::quiet_NaN() };  ///< per step, ms
+            double delta { std::numeric_limits<double>::quiet_NaN() };        ///< ms
+            double relativeDelta { std::numeric_limits<double>::quiet_NaN() };
+            double t { std::numeric_limits<double>::quiet_NaN() };            ///< Welch's t statistic
+        };
+
+        void compareTimers(const sofaimgui::ProfilerCapture& baseline, const sofaimgui::ProfilerCapture::Statistics& baselineStatistics,
+                           const sofaimgui::ProfilerCapture& capture, const sofaimgui::ProfilerCapture::Statistics& statistics,
+                           std::vector<TimerComparison>& comparisons)
+        {
+            comparisons.clear();
+            std::unordered_map<std::string, std::size_t> rows;
+            std::unordered_map<std::string, const sofaimgui::ProfilerCapture::TimerStatistics*> baselineTimers;
+            for (const auto& timer : baselineStatistics.timers)
+            {
+                auto& comparison = comparisons.emplace_back();
+                comparison.label = baseline.getLabel(timer.labelId);
+                comparison.baselineMean = timer.mean;
+                rows.emplace(comparison.label, comparisons.size() - 1);
+                baselineTimers.emplace(comparison.label, &timer);
+            }
 
-                sofa::type::vector<Chart> charts;
-                charts.reserve(selectedTimers.size());
+            for (const auto& timer : statistics.timers)
+            {
+                const auto& label = capture.getLabel(timer.labelId);
+                const auto [row, isNewRow] = rows.try_emplace(label, comparisons.size());
+                if (isNewRow)
+                {
+                    comparisons.emplace_back().label = label;
+                }
+                auto& comparison = comparisons[row->second];
+                comparison.currentMean = timer.mean;
 
-                if (showChart)
+                if (const auto it = baselineTimers.find(label); it != baselineTimers.end())
                 {
-                    for (const auto& records : allRecords)
+                    const auto& baselineTimer = *it->second;
+                    comparison.delta = timer.mean - baselineTimer.mean;
+                    comparison.relativeDelta = baselineTimer.mean > 0. ? comparison.delta / baselineTimer.mean : std::numeric_limits<double>::quiet_NaN();
+
+                    // the per-step durations of both captures are compared as two samples of unequal variances
+                    const double standardError = std::sqrt(
+                        baselineTimer.stddev * baselineTimer.stddev / static_cast<double>(baselineTimer.nbSteps)
+                        + timer.stddev * timer.stddev / static_cast<double>(timer.nbSteps));
+                    if (standardError > 0.)
                     {
-                        if (records.size() >= 2)
-                        {
-                            const auto tMin = records.front().time;
-                            const auto tMax = records.back().time;
-                            const auto frameDuration = convertInMs(tMax - tMin);
-                            frameChart.push_back(frameDuration);
-                        }
-                        else
-                        {
-                            frameChart.push_back(0.);
-                        }
+                        comparison.t = comparison.delta / standardError;
+                    }
+                    else
+                    {
+                        comparison.t = comparison.delta == 0. ? 0. : std::copysign(std::numeric_limits<double>::infinity(), comparison.delta);
                     }
+                }
+            }
+        }
+
+        /**
+         * Compares the mean duration per step of each timer between a baseline capture and the current one.
+         * A difference is highlighted when it is significant over the frames: |t| >= 2, i.e. about 95%
+         * confidence for captures of a few tens of frames or more.
+         */
+        void showComparison(const sofaimgui::ProfilerCapture& baseline, const std::string& baselineName,
+                            const sofaimgui::ProfilerCapture& capture)
+        {
+            static sofaimgui::ProfilerCapture::Statistics baselineStatistics;
+            static std::size_t baselineRevision = std::numeric_limits<std::size_t>::max();
+            static std::size_t statisticsRevision = std::numeric_limits<std::size_t>::max();
+            static std::vector<TimerComparison> comparisons;
+
+            const auto& sharedStatistics = getSharedStatistics(capture);
+            const auto& statistics = sharedStatistics.statistics;
+
+            bool isSortNeeded = false;
+            if (baselineRevision != baseline.getRevision() || statisticsRevision != sharedStatistics.revision)
+            {
+                if (baselineRevision != baseline.getRevision())
+                {
+                    baseline.computeStatistics(baselineStatistics);
+                    baselineRevision = baseline.getRevision();
+                }
+                statisticsRevision = sharedStatistics.revision;
+                compareTimers(baseline, baselineStatistics, capture, statistics, comparisons);
+                isSortNeeded = true;
+            }
 
-                    for (const auto timerId : selectedTimers)
+            ImGui::Text("Baseline: %s (%zu frames)", baselineName.c_str(), baselineStatistics.nbFrames);
+            if (baselineStatistics.nbFrames > 0 && statistics.nbFrames > 0)
+            {
+                const double baselineStep = baselineStatistics.totalFrameDuration / static_cast<double>(baselineStatistics.nbFrames);
+                const double currentStep = statistics.totalFrameDuration / static_cast<double>(statistics.nbFrames);
+                ImGui::Text("Average step duration (ms): %.3f -> %.3f (%+.1f%%)", baselineStep, currentStep,
+                            baselineStep > 0. ? 100. * (currentStep - baselineStep) / baselineStep : 0.);
+            }
+
+            static constexpr ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg;
+            const float columnWidth = ImGui::CalcTextSize("A").x * 10.0f;
+            if (ImGui::BeginTable("profilerComparison", 6, flags, ImVec2(0.f, ImGui::GetTextLineHeightWithSpacing() * 15)))
+            {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Label", ImGuiTableColumnFlags_NoHide);
+                ImGui::TableSetupColumn("Baseline (ms)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                ImGui::TableSetupColumn("Current (ms)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                ImGui::TableSetupColumn("Delta (ms)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending | ImGuiTableColumnFlags_DefaultSort, columnWidth);
+                ImGui::TableSetupColumn("Delta (%)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                ImGui::TableSetupColumn("t", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+                ImGui::TableHeadersRow();
+
+                if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs())
+                {
+                    if ((sortSpecs->SpecsDirty || isSortNeeded) && sortSpecs->SpecsCount > 0)
                     {
-                        Chart chart;
-                        for (const auto& records : allRecords)
+                        const auto& spec = sortSpecs->Specs[0];
+                        const auto key = [column = spec.ColumnIndex](const TimerComparison& comparison) -> double
                         {
-                            float value = 0.f;
-                            sofa::helper::system::thread::ctime_t t0;
-                            for (const auto& rec : records)
+                            switch (column)
                             {
-                                if (timerId == rec.id)
+                                case 1: return comparison.baselineMean;
+                                case 2: return comparison.currentMean;
+                                case 4: return comparison.relativeDelta;
+                                case 5: return comparison.t;
+                                default: return comparison.delta;
+                            }
+                        };
+                        const bool isAscending = spec.SortDirection == ImGuiSortDirection_Ascending;
+                        std::stable_sort(comparisons.begin(), comparisons.end(),
+                            [&](const TimerComparison& a, const TimerComparison& b)
+                            {
+                                if (spec.ColumnIndex == 0)
                                 {
-                                    chart.label = rec.label;
-                                    if (rec.type == sofa::helper::Record::RBEGIN || rec.type == sofa::helper::Record::RSTEP_BEGIN || rec.type == sofa::helper::Record::RSTEP)
-                                    {
-                                        t0 = rec.time;
-                                    }
-                                    if (rec.type == sofa::helper::Record::REND || rec.type == sofa::helper::Record::RSTEP_END)
-                                    {
-                                        value += convertInMs(rec.time - t0);
-                                    }
+                                    return isAscending ? a.label < b.label : a.label > b.label;
                                 }
-                            }
-                            chart.values.push_back(value);
+                                const double keyA = key(a);
+                                const double keyB = key(b);
+                                // the missing values (NaN) are always last, whatever the direction
+                                if (std::isnan(keyA) || std::isnan(keyB))
+                                {
+                                    return !std::isnan(keyA) && std::isnan(keyB);
+                                }
+                                return isAscending ? keyA < keyB : keyA > keyB;
+                            });
+                        sortSpecs->SpecsDirty = false;
+                    }
+                }
+
+                const auto showValue = [](const char* format, const double value)
+                {
+                    if (std::isnan(value))
+                    {
+                        ImGui::TextDisabled("-");
+                    }
+                    else
+                    {
+                        ImGui::Text(format, value);
+                    }
+                };
+
+                for (const auto& comparison : comparisons)
+                {
+                    const bool isSignificant = std::abs(comparison.t) >= 2.;
+                    if (isSignificant)
+                    {
+                        ImGui::PushStyleColor(ImGuiCol_Text, comparison.delta > 0. ? ImVec4(1.f, 0.4f, 0.4f, 1.f) : ImVec4(0.4f, 1.f, 0.4f, 1.f));
+                    }
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", comparison.label.c_str());
+                    ImGui::TableNextColumn();
+                    showValue("%.3f", comparison.baselineMean);
+                    ImGui::TableNextColumn();
+                    showValue("%.3f", comparison.currentMean);
+                    ImGui::TableNextColumn();
+                    showValue("%+.3f", comparison.delta);
+                    ImGui::TableNextColumn();
+                    showValue("%+.1f", 100. * comparison.relativeDelta);
+                    ImGui::TableNextColumn();
+                    showValue("%.2f", comparison.t);
+
+                    if (isSignificant)
+                    {
+                        ImGui::PopStyleColor();
+                    }
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        /**
+         * Draws the intervals of a frame as an icicle (root on top) or a flame graph (root at the bottom):
+         * the width of a box is proportional to its duration. Ctrl + mouse wheel zooms around the cursor,
+         * and clicking a box selects its timer for the chart.
+         */
+        void showFlameGraph(const sofaimgui::ProfilerCapture& capture,
+                            const std::vector<sofaimgui::ProfilerCapture::Span>& spans,
+                            const sofa::helper::system::thread::ctime_t tStart,
+                            const sofa::helper::system::thread::ctime_t tEnd,
+                            std::unordered_set<int>& selectedTimers)
+        {
+            static bool isFlame = false;
+            static float zoom = 1.f;
+            ImGui::Checkbox("Flame (root at the bottom)", &isFlame);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(ImGui::CalcTextSize("A").x * 12.0f);
+            ImGui::SliderFloat("Zoom", &zoom, 1.f, 1000.f, "%.1fx", ImGuiSliderFlags_Logarithmic);
+
+            unsigned int nbLevels = 0;
+            for (const auto& span : spans)
+            {
+                nbLevels = std::max(nbLevels, span.depth + 1);
+            }
+            if (nbLevels == 0 || tEnd <= tStart)
+            {
+                return;
+            }
+
+            const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+            const float height = std::min(nbLevels * rowHeight, 20 * rowHeight) + ImGui::GetStyle().ScrollbarSize;
+            if (ImGui::BeginChild("flameGraph", ImVec2(0, height), true, ImGuiWindowFlags_HorizontalScrollbar))
+            {
+                const ImVec2 origin = ImGui::GetCursorScreenPos();
+                const float width = ImGui::GetContentRegionAvail().x * zoom;
+                const double totalDuration = static_cast<double>(tEnd - tStart);
+
+                // zoom around the cursor
+                const ImGuiIO& io = ImGui::GetIO();
+                if (ImGui::IsWindowHovered() && io.KeyCtrl && io.MouseWheel != 0.f)
+                {
+                    const float newZoom = std::clamp(zoom * std::pow(1.2f, io.MouseWheel), 1.f, 1000.f);
+                    const float cursorInContent = io.MousePos.x - origin.x;
+                    const float cursorInWindow = io.MousePos.x - ImGui::GetWindowPos().x;
+                    ImGui::SetScrollX(std::max(0.f, cursorInContent * newZoom / zoom - cursorInWindow));
+                    zoom = newZoom;
+                }
+
+                ImDrawList* drawList = ImGui::GetWindowDrawList();
+                const ImVec2 clipMin = drawList->GetClipRectMin();
+                const ImVec2 clipMax = drawList->GetClipRectMax();
+                const float frameDuration = sofaimgui::ProfilerCapture::toMilliseconds(tEnd - tStart);
+                int clickedTimer = -1;
+
+                for (const auto& span : spans)
+                {
+                    const float x0 = origin.x + static_cast<float>((span.begin - tStart) / totalDuration) * width;
+                    const float x1 = std::max(x0 + 1.f, origin.x + static_cast<float>((span.end - tStart) / totalDuration) * width);
+                    const unsigned int level = isFlame ? nbLevels - 1 - span.depth : span.depth;
+                    const float y0 = origin.y + level * rowHeight;
+                    const float y1 = y0 + rowHeight - 1.f;
+                    if (x1 < clipMin.x || x0 > clipMax.x || y1 < clipMin.y || y0 > clipMax.y)
+                    {
+                        continue;
+                    }
+
+                    // a stable color per label
+                    ImVec4 color(0.f, 0.f, 0.f, 1.f);
+                    const float hue = static_cast<float>((span.labelId * 0.618034) - std::floor(span.labelId * 0.618034));
+                    ImGui::ColorConvertHSVtoRGB(hue, 0.5f, 0.85f, color.x, color.y, color.z);
+                    const bool isSelected = selectedTimers.find(span.id) != selectedTimers.end();
+                    drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), ImGui::ColorConvertFloat4ToU32(color));
+                    if (isSelected)
+                    {
+                        drawList->AddRect(ImVec2(x0, y0), ImVec2(x1, y1), IM_COL32(255, 255, 255, 255), 0.f, 0, 2.f);
+                    }
+
+                    const auto& label = capture.getLabel(span.labelId);
+                    if (x1 - x0 > ImGui::CalcTextSize("...").x)
+                    {
+                        const ImVec4 textClip(std::max(x0, clipMin.x), y0, std::min(x1, clipMax.x), y1);
+                        drawList->AddText(nullptr, 0.f, ImVec2(std::max(x0, clipMin.x) + 2.f, y0), IM_COL32(0, 0, 0, 255), label.c_str(), nullptr, 0.f, &textClip);
+                    }
+
+                    if (ImGui::IsWindowHovered() && ImGui::IsMouseHoveringRect(ImVec2(x0, y0), ImVec2(x1, y1)))
+                    {
+                        const auto spanDuration = sofaimgui::ProfilerCapture::toMilliseconds(span.end - span.begin);
+                        ImGui::BeginTooltip();
+                        ImGui::Text("%s", label.c_str());
+                        ImGui::TextDisabled("Duration (ms): %f", spanDuration);
+                        ImGui::TextDisabled("Percent (%%): %.2f", 100. * spanDuration / frameDuration);
+                        ImGui::TextDisabled("ID: %u", span.id);
+                        ImGui::EndTooltip();
+                        if (ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+                        {
+                            clickedTimer = static_cast<int>(span.id);
                         }
-                        charts.push_back(chart);
                     }
+                }
+
+                ImGui::Dummy(ImVec2(width, nbLevels * rowHeight));
+
+                if (clickedTimer != -1)
+                {
+                    const auto it = selectedTimers.find(clickedTimer);
+                    if (it == selectedTimers.end())
+                    {
+                        selectedTimers.insert(clickedTimer);
+                    }
+                    else
+                    {
+                        selectedTimers.erase(it);
+                    }
+                }
+            }
+            ImGui::EndChild();
+        }
+
+        /**
+         * Shows the settings of the spike capture, the pinned spikes, and the frames pinned around the
+         * selected spike.
+         */
+        void showSpikeCapture(sofaimgui::SpikeCapture& spikeCapture, bool& isEnabled, bool& isPausingOnSpike,
+                              std::unordered_set<int>& selectedTimers)
+        {
+            ImGui::Checkbox("Enable##spikeCapture", &isEnabled);
+            ImGui::SameLine();
+            ImGui::Checkbox("Pause on spike", &isPausingOnSpike);
+
+            auto& settings = spikeCapture.getSettings();
+            if (ImGui::RadioButton("Absolute threshold", !settings.isRelative))
+            {
+                settings.isRelative = false;
+            }
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Multiple of the running median", settings.isRelative))
+            {
+                settings.isRelative = true;
+            }
+            if (settings.isRelative)
+            {
+                ImGui::DragFloat("Threshold (x median)", &settings.relativeThreshold, 0.05f, 1.f, 100.f, "%.2f");
+            }
+            else
+            {
+                ImGui::DragFloat("Threshold (ms)", &settings.absoluteThreshold, 0.1f, 0.f, 10000.f, "%.3f");
+            }
+            ImGui::SliderInt("Steps pinned around a spike", &settings.nbContextFrames, 0, 50);
+
+            const float threshold = spikeCapture.getThreshold();
+            if (std::isinf(threshold))
+            {
+                ImGui::TextDisabled("Estimating the running median...");
+            }
+            else
+            {
+                ImGui::Text("Current threshold (ms): %.3f", threshold);
+            }
+
+            const auto& spikes = spikeCapture.getSpikes();
+            ImGui::Text("%zu pinned spikes", spikes.size());
+            ImGui::SameLine();
+            if (ImGui::Button(ICON_FA_TIMES_CIRCLE "  Clear spikes"))
+            {
+                spikeCapture.clear();
+            }
+
+            // the spikes are identified by their frame number: their index changes when the oldest are discarded
+            static std::size_t selectedFrameNumber = 0;
+            const auto selectedSpike = std::find_if(spikes.begin(), spikes.end(), [](const auto& spike)
+            {
+                return spike.frameNumber == selectedFrameNumber;
+            });
+
+            static constexpr ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_RowBg;
+            const float columnWidth = ImGui::CalcTextSize("A").x * 10.0f;
+            if (ImGui::BeginTable("profilerSpikes", 3, flags, ImVec2(0.f, ImGui::GetTextLineHeightWithSpacing() * 8)))
+            {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("Frame", ImGuiTableColumnFlags_NoHide);
+                ImGui::TableSetupColumn("Duration (ms)", ImGuiTableColumnFlags_WidthFixed, columnWidth);
+                ImGui::TableSetupColumn("Threshold (ms)", ImGuiTableColumnFlags_WidthFixed, columnWidth);
+                ImGui::TableHeadersRow();
+
+                // the most recent spikes first
+                for (auto it = spikes.rbegin(); it != spikes.rend(); ++it)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    const std::string label = std::to_string(it->frameNumber) + (it->nbMissingFrames > 0 ? " (recording)" : "");
+                    if (ImGui::Selectable(label.c_str(), it->frameNumber == selectedFrameNumber, ImGuiSelectableFlags_SpanAllColumns))
+                    {
+                        selectedFrameNumber = it->frameNumber;
+                    }
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", it->duration);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", it->threshold);
+                }
+                ImGui::EndTable();
+            }
+
+            if (selectedSpike == spikes.end())
+            {
+                return;
+            }
+
+            const auto& spike = *selectedSpike;
+            if (ImGui::Button(ICON_FA_SAVE "  Save spike"))
+            {
+                nfdchar_t *outPath;
+                std::array<nfdfilteritem_t, 1> filterItem{ {"SOFA profiler capture", "sofaprof"} };
+                const std::string defaultName = "spike_" + std::to_string(spike.frameNumber) + ".sofaprof";
+                const nfdresult_t result = NFD_SaveDialog(&outPath, filterItem.data(), filterItem.size(), nullptr, defaultName.c_str());
+                if (result == NFD_OKAY)
+                {
+                    spike.frames.save(outPath);
+                    NFD_FreePath(outPath);
+                }
+            }
+
+            if (ImPlot::BeginPlot("##SpikeFrames", ImVec2(-1.f, ImGui::GetTextLineHeightWithSpacing() * 8)))
+            {
+                ImPlot::SetupAxes("Pinned step", "Duration (ms)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+                const auto& frameDurations = spike.frames.getFrameDurations();
+                ImPlot::PlotBars("Steps", frameDurations.data(), frameDurations.size(), 0.67);
+                ImPlot::PlotBars("Spike", &spike.duration, 1, 0.67, static_cast<double>(spike.spikeFrameIndex));
+                ImPlot::EndPlot();
+            }
+
+            const auto frame = spike.frames.getFrame(spike.spikeFrameIndex);
+            if (!frame.empty())
+            {
+                auto tStart = frame.front().time;
+                auto tEnd = tStart;
+                for (const auto& entry : frame)
+                {
+                    tStart = std::min(tStart, entry.time);
+                    tEnd = std::max(tEnd, entry.time);
+                }
+
+                static std::vector<sofaimgui::ProfilerCapture::Span> spans;
+                spike.frames.computeSpans(spike.spikeFrameIndex, spans);
+                ImGui::PushID("spike");
+                showFlameGraph(spike.frames, spans, tStart, tEnd, selectedTimers);
+                ImGui::PopID();
+            }
+        }
+    }
+
+    void showProfiler(sofa::core::sptr<sofa::simulation::Node> groot
+            , const char* const& windowNameProfiler
+            , WindowState& winManagerProfiler
+            , sofaimgui::ProfilingState& profilingState)
+    {
+        if (*winManagerProfiler.getStatePtr())
+        {
+            static int selectedFrame = 0;
+
+            if (ImGui::Begin(windowNameProfiler, winManagerProfiler.getStatePtr()))
+            {
+                const auto convertInMs = &sofaimgui::ProfilerCapture::toMilliseconds;
 
+                static sofaimgui::ProfilerCapture capture;
+                static int bufferSize = 500;
+                static constexpr std::array<const char*, 3> modeNames { "Off", "Sampled", "Continuous" };
+                int mode = static_cast<int>(profilingState.getMode());
+                ImGui::SetNextItemWidth(ImGui::CalcTextSize("A").x * 14.0f);
+                if (ImGui::Combo("Recording", &mode, modeNames.data(), static_cast<int>(modeNames.size())))
+                {
+                    profilingState.setMode(static_cast<sofaimgui::ProfilingState::Mode>(mode));
+                }
+                if (profilingState.getMode() == sofaimgui::ProfilingState::Mode::Sampled)
+                {
+                    ImGui::SameLine();
+                    int samplingPeriod = static_cast<int>(profilingState.getSamplingPeriod());
+                    ImGui::SetNextItemWidth(ImGui::CalcTextSize("A").x * 14.0f);
+                    if (ImGui::InputInt("Sampling period (steps)", &samplingPeriod))
+                    {
+                        profilingState.setSamplingPeriod(static_cast<unsigned int>(std::max(1, samplingPeriod)));
+                    }
+                }
+
+                // the number of frames is only bounded by the arena of the capture, whose size is capped
+                const int maxBufferSize = static_cast<int>(std::min<std::size_t>(capture.getMaxCapacity(), std::numeric_limits<int>::max()));
+                ImGui::SetNextItemWidth(ImGui::CalcTextSize("A").x * 14.0f);
+                if (ImGui::InputInt("Buffer size (frames)", &bufferSize, 100, 1000))
+                {
+                    bufferSize = std::clamp(bufferSize, 10, std::max(10, maxBufferSize));
+                }
+                if (capture.isLimitedByEntries())
+                {
+                    ImGui::SameLine();
+                    ImGui::TextColored(ImVec4(1.f, 0.4275f, 0.f, 1.f), ICON_FA_EXCLAMATION_TRIANGLE " %zu frames kept: the capture is limited to %zu records",
+                                       capture.getNbFrames(), sofaimgui::ProfilerCapture::maxNbEntries);
+                }
+                selectedFrame = std::min(selectedFrame, bufferSize - 1);
+                capture.setCapacity(bufferSize);
+
+                static bool showChart = true;
+                ImGui::Checkbox("Show Chart", &showChart);
+                ImGui::SameLine();
+                if (ImGui::Button(ICON_FA_SAVE "  Export trace"))
+                {
+                    nfdchar_t *outPath;
+                    std::array<nfdfilteritem_t, 1> filterItem{ {"Chrome Trace / Perfetto", "json"} };
+                    const nfdresult_t result = NFD_SaveDialog(&outPath, filterItem.data(), filterItem.size(), nullptr, "trace.json");
+                    if (result == NFD_OKAY)
+                    {
+                        capture.writeTrace(outPath);
+                        NFD_FreePath(outPath);
+                    }
+                }
+
+                // a capture saved earlier, compared with the current one
+                static sofaimgui::ProfilerCapture baseline;
+                static std::string baselineName;
+                static constexpr std::array<nfdfilteritem_t, 1> captureFilterItem{ {"SOFA profiler capture", "sofaprof"} };
+                ImGui::SameLine();
+                if (ImGui::Button(ICON_FA_SAVE "  Save capture"))
+                {
+                    nfdchar_t *outPath;
+                    const nfdresult_t result = NFD_SaveDialog(&outPath, captureFilterItem.data(), captureFilterItem.size(), nullptr, "capture.sofaprof");
+                    if (result == NFD_OKAY)
+                    {
+                        capture.save(outPath);
+                        NFD_FreePath(outPath);
+                    }
+                }
+                ImGui::SameLine();
+                if (ImGui::Button(ICON_FA_FOLDER_OPEN "  Load baseline"))
+                {
+                    nfdchar_t *outPath;
+                    const nfdresult_t result = NFD_OpenDialog(&outPath, captureFilterItem.data(), captureFilterItem.size(), nullptr);
+                    if (result == NFD_OKAY)
+                    {
+                        baselineName = baseline.load(outPath) ? std::string(outPath) : std::string();
+                        NFD_FreePath(outPath);
+                    }
+                }
+                if (!baselineName.empty())
+                {
+                    ImGui::SameLine();
+                    if (ImGui::Button(ICON_FA_TIMES_CIRCLE "  Clear baseline"))
+                    {
+                        baseline.clear();
+                        baselineName.clear();
+                    }
+                }
+
+                // the outliers are copied before they are overwritten in the buffer
+                static sofaimgui::SpikeCapture spikeCapture;
+                static bool isSpikeCaptureEnabled = false;
+                static bool isPausingOnSpike = false;
+
+                // the timer only holds the records of the last step if it was recording during this step
+                if (groot->animate_.getValue() && profilingState.isRecording())
+                {
+                    capture.addFrame(sofa::helper::AdvancedTimer::getRecords("Animate"));
+                    if (isSpikeCaptureEnabled && spikeCapture.onFrameAdded(capture) && isPausingOnSpike)
+                    {
+                        sofa::helper::getWriteOnlyAccessor(groot->animate_).wref() = false;
+                    }
+                }
+
+                static std::unordered_set<int> selectedTimers;
+
+                if (showChart)
+                {
+                    // the summaries are computed when the frames are added: the rings are plotted as they are
                     static double selectedFrameInChart = selectedFrame;
                     selectedFrameInChart = selectedFrame;
                     if (ImPlot::BeginPlot("##ProfilerChart"))
@@ -157,51 +832,68 @@ namespace windows {
                         {
                             selectedFrame = std::round(selectedFrameInChart);
                         }
-                        ImPlot::PlotLine("Total", frameChart.data(), frameChart.size());
-                        for (const auto& chart : charts)
+                        const auto& frameDurations = capture.getFrameDurations();
+                        ImPlot::PlotLine("Total", frameDurations.data(), frameDurations.size());
+                        for (const auto timerId : selectedTimers)
                         {
-                            ImPlot::PlotLine(chart.label.c_str(), chart.values.data(), chart.values.size());
+                            if (const auto* timer = capture.getTimerHistory(timerId))
+                            {
+                                ImPlot::PlotLine(timer->label.c_str(), timer->durations.data(), timer->durations.size());
+                            }
                         }
                         ImPlot::EndPlot();
                     }
                 }
 
-                ImGui::SliderInt("Frame", &selectedFrame, 0, allRecords.size());
+                if (ImGui::CollapsingHeader("Statistics over the buffer"))
+                {
+                    showStatistics(capture);
+                }
+
+                if (!baselineName.empty() && ImGui::CollapsingHeader("Comparison with the baseline"))
+                {
+                    showComparison(baseline, baselineName, capture);
+                }
+
+                if (ImGui::CollapsingHeader("Spike capture"))
+                {
+                    showSpikeCapture(spikeCapture, isSpikeCaptureEnabled, isPausingOnSpike, selectedTimers);
+                }
 
+                ImGui::SliderInt("Frame", &selectedFrame, 0, capture.getNbFrames());
 
-                if (selectedFrame >= 0 && selectedFrame < allRecords.size())
+
+                if (selectedFrame >= 0 && selectedFrame < capture.getNbFrames())
                 {
-                    const auto records = allRecords[selectedFrame];
+                    const auto records = capture.getFrame(selectedFrame); // view on the entries, no copy
                     if (!records.empty())
                     {
                         auto tStart = records.front().time;
                         auto tEnd = tStart;
-                        std::unordered_map<unsigned int, SReal > duration;
-                        std::stack<sofa::helper::system::thread::ctime_t> durationStack;
-                        std::stack<unsigned int> timerIdStack;
-                        unsigned int timerIdCounter {};
-                        for (const auto& rec : allRecords[selectedFrame])
+                        for (const auto& rec : records)
                         {
                             tStart = std::min(tStart, rec.time);
                             tEnd = std::max(tEnd, rec.time);
+                        }
 
-                            if (rec.type == sofa::helper::Record::RBEGIN || rec.type == sofa::helper::Record::RSTEP_BEGIN || rec.type == sofa::helper::Record::RSTEP)
-                            {
-                                durationStack.push(rec.time);
-                                timerIdStack.push(timerIdCounter++);
-                            }
-                            if (rec.type == sofa::helper::Record::REND || rec.type == sofa::helper::Record::RSTEP_END)
-                            {
-                                const auto t = durationStack.top();
-                                durationStack.pop();
-                                duration[timerIdStack.top()] = convertInMs(rec.time - t);
-                                timerIdStack.pop();
-                            }
+                        // the intervals are in the order of their begin records, like the rows of the table
+                        static std::vector<sofaimgui::ProfilerCapture::Span> spans;
+                        capture.computeSpans(selectedFrame, spans);
+                        std::unordered_map<unsigned int, SReal > duration;
+                        for (unsigned int i = 0; i < spans.size(); ++i)
+                        {
+                            duration[i] = convertInMs(spans[i].end - spans[i].begin);
                         }
+                        unsigned int timerIdCounter {};
 
                         const auto frameDuration = convertInMs(tEnd - tStart);
                         ImGui::Text("Frame duration (ms): %f", frameDuration);
 
+                        if (ImGui::CollapsingHeader("Flame graph"))
+                        {
+                            showFlameGraph(capture, spans, tStart, tEnd, selectedTimers);
+                        }
+
                         const bool expand = ImGui::Button(ICON_FA_EXPAND);
                         ImGui::SameLine();
                         const bool collapse = ImGui::Button(ICON_FA_COMPRESS);
@@ -222,7 +914,7 @@ namespace windows {
                             for (auto it = records.begin(); it != records.end(); ++it)
                             {
                                 const auto& rec = *it;
-                                if (rec.type == sofa::helper::Record::RBEGIN || rec.type == sofa::helper::Record::RSTEP_BEGIN || rec.type == sofa::helper::Record::RSTEP)
+                                if (sofaglfw::isBeginRecord(rec.type))
                                 {
                                     if (openStack.empty() || openStack.top())
                                     {
@@ -235,7 +927,7 @@ namespace windows {
                                         if (it + 1 != records.end())
                                         {
                                             const auto& nextRec = *(it + 1);
-                                            if (it->label == nextRec.label && (nextRec.type == sofa::helper::Record::REND || nextRec.type == sofa::helper::Record::RSTEP_END))
+                                            if (it->labelId == nextRec.labelId && sofaglfw::isEndRecord(nextRec.type))
                                             {
                                                 node_flags |= ImGuiTreeNodeFlags_Leaf;
                                             }
@@ -246,11 +938,12 @@ namespace windows {
                                         ImGui::TableNextColumn();
                                         if (expand) ImGui::SetNextItemOpen(true);
                                         if (collapse) ImGui::SetNextItemOpen(false);
-                                        const bool isOpen = ImGui::TreeNodeEx(rec.label.c_str(), node_flags);
+                                        const auto& label = capture.getLabel(rec.labelId);
+                                        const bool isOpen = ImGui::TreeNodeEx(label.c_str(), node_flags);
                                         if (ImGui::IsItemHovered())
                                         {
                                             ImGui::BeginTooltip();
-                                            ImGui::TextDisabled(rec.label.c_str());
+                                            ImGui::TextDisabled(label.c_str());
                                             ImGui::TextDisabled("ID: %s", std::to_string(rec.id).c_str());
                                             ImGui::EndTooltip();
                                         }
@@ -259,11 +952,13 @@ namespace windows {
                                         if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
                                             node_clicked = rec.id;
 
-                                        const auto& d = (rec.label == "Animate") ? frameDuration : duration[timerIdCounter];
+                                        // the first record is the root timer ("Animate")
+                                        const bool isRoot = it == records.begin();
+                                        const auto& d = isRoot ? frameDuration : duration[timerIdCounter];
 
                                         ImVec4 color;
                                         color.w = 1.f;
-                                        const auto ratio = (rec.label == "Animate") ? 1. : d/frameDuration;
+                                        const auto ratio = isRoot ? 1. : d/frameDuration;
                                         constexpr auto clamp = [](double d){ return std::max(0., std::min(1., d));};
                                         ImGui::ColorConvertHSVtoRGB(120./360. * clamp(1.-ratio*10.), 0.72f, 1.f, color.x,color.y, color.z);
                                         ImGui::TableNextColumn();
@@ -278,7 +973,7 @@ namespace windows {
                                     }
                                     ++timerIdCounter;
                                 }
-                                if (rec.type == sofa::helper::Record::REND || rec.type == sofa::helper::Record::RSTEP_END)
+                                if (sofaglfw::isEndRecord(rec.type))
                                 {
                                     if (openStack.top())
                                     {
@@ -31,6 +31,7 @@
 #include <imgui.h>
 #include <sofa/simulation/Node.h>
 #include <SimpleIni.h>
+#include <SofaImGui/ProfilingState.h>
 #include "WindowState.h"
 
 
@@ -45,9 +46,11 @@ namespace windows
      * @param groot The root node of the simulation.
      * @param windowNameProfiler The name of the Profiler window.
      * @param isProfilerOpen A reference to a boolean flag indicating if the Profiler window is open.
+     * @param profilingState The recording mode of the timers, changed from the window.
      */
     void showProfiler(sofa::core::sptr<sofa::simulation::Node> groot,
                       const char* const& windowNameProfiler,
-                      WindowState& winManagerProfiler);
+                      WindowState& winManagerProfiler,
+                      sofaimgui::ProfilingState& profilingState);
 
 } // namespace sofaimgui
\ No newline at end of file
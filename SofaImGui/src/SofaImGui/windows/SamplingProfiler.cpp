@@ -0,0 +1,327 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#include <imgui.h>
+#include <IconsFontAwesome5.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "SamplingProfiler.h"
+
+namespace windows
+{
+
+    namespace
+    {
+        using Results = sofaimgui::SamplingProfiler::Results;
+
+        void showTopFunctions(Results& results, const bool isSortNeeded)
+        {
+            static ImGuiTextFilter filter;
+            filter.Draw("Filter");
+
+            static constexpr ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg;
+            const float columnWidth = ImGui::CalcTextSize("A").x * 10.0f;
+            if (!ImGui::BeginTable("samplingTopFunctions", 5, flags, ImVec2(0.f, ImGui::GetTextLineHeightWithSpacing() * 20)))
+            {
+                return;
+            }
+
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Function", ImGuiTableColumnFlags_NoHide);
+            ImGui::TableSetupColumn("Self (%)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending | ImGuiTableColumnFlags_DefaultSort, columnWidth);
+            ImGui::TableSetupColumn("Total (%)", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+            ImGui::TableSetupColumn("Self", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+            ImGui::TableSetupColumn("Total", ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending, columnWidth);
+            ImGui::TableHeadersRow();
+
+            if (ImGuiTableSortSpecs* sortSpecs = ImGui::TableGetSortSpecs())
+            {
+                if ((sortSpecs->SpecsDirty || isSortNeeded) && sortSpecs->SpecsCount > 0)
+                {
+                    const auto& spec = sortSpecs->Specs[0];
+                    const bool isAscending = spec.SortDirection == ImGuiSortDirection_Ascending;
+                    std::sort(results.statistics.begin(), results.statistics.end(), [&](const auto& a, const auto& b)
+                    {
+                        if (spec.ColumnIndex == 0)
+                        {
+                            const auto comparison = results.functions[a.functionId].compare(results.functions[b.functionId]);
+                            return isAscending ? comparison < 0 : comparison > 0;
+                        }
+                        const bool isTotal = spec.ColumnIndex == 2 || spec.ColumnIndex == 4;
+                        const auto keyA = isTotal ? a.totalSamples : a.selfSamples;
+                        const auto keyB = isTotal ? b.totalSamples : b.selfSamples;
+                        return isAscending ? keyA < keyB : keyA > keyB;
+                    });
+                    sortSpecs->SpecsDirty = false;
+                }
+            }
+
+            const double nbSamples = static_cast<double>(std::max<std::size_t>(1, results.nbSamples));
+            const auto showRow = [&results, nbSamples](const sofaimgui::SamplingProfiler::FunctionStatistics& function)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(results.functions[function.functionId].c_str());
+                if (ImGui::IsItemHovered())
+                {
+                    ImGui::SetTooltip("%s", results.functions[function.functionId].c_str());
+                }
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", 100. * static_cast<double>(function.selfSamples) / nbSamples);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", 100. * static_cast<double>(function.totalSamples) / nbSamples);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", function.selfSamples);
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", function.totalSamples);
+            };
+
+            if (filter.IsActive())
+            {
+                for (const auto& function : results.statistics)
+                {
+                    if (filter.PassFilter(results.functions[function.functionId].c_str()))
+                    {
+                        showRow(function);
+                    }
+                }
+            }
+            else
+            {
+                // only the visible rows are submitted: there can be thousands of functions
+                ImGuiListClipper clipper;
+                clipper.Begin(static_cast<int>(results.statistics.size()));
+                while (clipper.Step())
+                {
+                    for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+                    {
+                        showRow(results.statistics[row]);
+                    }
+                }
+            }
+            ImGui::EndTable();
+        }
+
+        /**
+         * Draws the merged call stacks as an icicle: the width of a box is proportional to its number of
+         * samples. Clicking a box focuses the graph on it.
+         */
+        void showCallStacks(const Results& results)
+        {
+            static std::size_t focusedNode = 0;
+            if (focusedNode >= results.callTree.size())
+            {
+                focusedNode = 0;
+            }
+            if (results.callTree.empty() || results.callTree[focusedNode].samples == 0)
+            {
+                ImGui::TextDisabled("No sample");
+                return;
+            }
+
+            if (ImGui::Button(ICON_FA_COMPRESS "  Show all"))
+            {
+                focusedNode = 0;
+            }
+
+            struct Box
+            {
+                std::size_t node;
+                unsigned int depth;
+                double begin; ///< in samples, from the beginning of the focused node
+            };
+            static std::vector<Box> boxes;
+            boxes.clear();
+            unsigned int nbLevels = 0;
+            std::vector<Box> stack { {focusedNode, 0, 0.} };
+            while (!stack.empty())
+            {
+                const Box box = stack.back();
+                stack.pop_back();
+                boxes.push_back(box);
+                nbLevels = std::max(nbLevels, box.depth + 1);
+
+                double childBegin = box.begin;
+                for (const auto& [functionId, child] : results.callTree[box.node].children)
+                {
+                    stack.push_back({child, box.depth + 1, childBegin});
+                    childBegin += static_cast<double>(results.callTree[child].samples);
+                }
+            }
+
+            const float rowHeight = ImGui::GetTextLineHeightWithSpacing();
+            const float height = std::min(nbLevels * rowHeight, 30 * rowHeight) + ImGui::GetStyle().ScrollbarSize;
+            if (ImGui::BeginChild("samplingCallStacks", ImVec2(0, height), true))
+            {
+                const ImVec2 origin = ImGui::GetCursorScreenPos();
+                const float width = ImGui::GetContentRegionAvail().x;
+                const double nbFocusedSamples = static_cast<double>(results.callTree[focusedNode].samples);
+                const double nbSamples = static_cast<double>(std::max<std::size_t>(1, results.callTree[0].samples));
+
+                ImDrawList* drawList = ImGui::GetWindowDrawList();
+                const ImVec2 clipMin = drawList->GetClipRectMin();
+                const ImVec2 clipMax = drawList->GetClipRectMax();
+                std::size_t clickedNode = std::numeric_limits<std::size_t>::max();
+
+                for (const auto& box : boxes)
+                {
+                    const auto& node = results.callTree[box.node];
+                    const float x0 = origin.x + static_cast<float>(box.begin / nbFocusedSamples) * width;
+                    const float x1 = origin.x + static_cast<float>((box.begin + static_cast<double>(node.samples)) / nbFocusedSamples) * width;
+                    const float y0 = origin.y + box.depth * rowHeight;
+                    const float y1 = y0 + rowHeight - 1.f;
+                    if (x1 - x0 < 1.f || x1 < clipMin.x || x0 > clipMax.x || y1 < clipMin.y || y0 > clipMax.y)
+                    {
+                        continue;
+                    }
+
+                    // a stable color per function, the virtual root in gray
+                    ImVec4 color(0.5f, 0.5f, 0.5f, 1.f);
+                    if (box.node != 0)
+                    {
+                        const double hue = node.functionId * 0.618034 - std::floor(node.functionId * 0.618034);
+                        ImGui::ColorConvertHSVtoRGB(static_cast<float>(hue), 0.5f, 0.85f, color.x, color.y, color.z);
+                    }
+                    drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), ImGui::ColorConvertFloat4ToU32(color));
+
+                    const char* name = box.node == 0 ? "all" : results.functions[node.functionId].c_str();
+                    if (x1 - x0 > ImGui::CalcTextSize("...").x)
+                    {
+                        const ImVec4 textClip(std::max(x0, clipMin.x), y0, std::min(x1, clipMax.x), y1);
+                        drawList->AddText(nullptr, 0.f, ImVec2(std::max(x0, clipMin.x) + 2.f, y0), IM_COL32(0, 0, 0, 255), name, nullptr, 0.f, &textClip);
+                    }
+
+                    if (ImGui::IsWindowHovered() && ImGui::IsMouseHoveringRect(ImVec2(x0, y0), ImVec2(x1, y1)))
+                    {
+                        ImGui::BeginTooltip();
+                        ImGui::Text("%s", name);
+                        ImGui::TextDisabled("Samples: %zu", node.samples);
+                        ImGui::TextDisabled("Percent (%%): %.2f", 100. * static_cast<double>(node.samples) / nbSamples);
+                        ImGui::EndTooltip();
+                        if (ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+                        {
+                            clickedNode = box.node;
+                        }
+                    }
+                }
+                ImGui::Dummy(ImVec2(width, nbLevels * rowHeight));
+
+                if (clickedNode != std::numeric_limits<std::size_t>::max())
+                {
+                    focusedNode = clickedNode;
+                }
+            }
+            ImGui::EndChild();
+        }
+    }
+
+    void showSamplingProfiler(const char* const& windowNameSamplingProfiler,
+                              WindowState& winManagerSamplingProfiler,
+                              sofaimgui::SamplingProfiler& samplingProfiler)
+    {
+        if (!*winManagerSamplingProfiler.getStatePtr())
+        {
+            // no sampling while nobody looks at the results
+            samplingProfiler.stop();
+            return;
+        }
+
+        if (ImGui::Begin(windowNameSamplingProfiler, winManagerSamplingProfiler.getStatePtr()))
+        {
+            if (!sofaimgui::SamplingProfiler::isAvailable())
+            {
+                ImGui::TextDisabled("The sampling profiler is only available on Linux, on x86-64 and AArch64");
+                ImGui::End();
+                return;
+            }
+
+            static int frequency = 1000;
+            ImGui::SetNextItemWidth(ImGui::CalcTextSize("A").x * 20.0f);
+            if (samplingProfiler.isRunning())
+            {
+                ImGui::BeginDisabled();
+            }
+            ImGui::SliderInt("Samples per second of CPU time", &frequency, 10, 10000, "%d", ImGuiSliderFlags_Logarithmic);
+            if (samplingProfiler.isRunning())
+            {
+                ImGui::EndDisabled();
+            }
+
+            if (samplingProfiler.isRunning())
+            {
+                if (ImGui::Button(ICON_FA_PAUSE "  Stop"))
+                {
+                    samplingProfiler.stop();
+                }
+            }
+            else if (ImGui::Button(ICON_FA_PLAY "  Start"))
+            {
+                samplingProfiler.start(static_cast<unsigned int>(frequency));
+            }
+            ImGui::SameLine();
+            if (ImGui::Button(ICON_FA_REDO "  Reset"))
+            {
+                samplingProfiler.reset();
+            }
+
+            // the results are copied from the aggregation thread at most twice per second
+            static Results results;
+            static std::size_t resultsRevision = std::numeric_limits<std::size_t>::max();
+            static double lastUpdateTime = 0.;
+            bool isSortNeeded = false;
+            if (resultsRevision != samplingProfiler.getRevision() && ImGui::GetTime() - lastUpdateTime > 0.5)
+            {
+                resultsRevision = samplingProfiler.getRevision();
+                samplingProfiler.getResults(results);
+                lastUpdateTime = ImGui::GetTime();
+                isSortNeeded = true;
+            }
+
+            ImGui::Text("%zu samples", results.nbSamples);
+            if (results.nbDroppedSamples > 0)
+            {
+                ImGui::SameLine();
+                ImGui::TextDisabled("(%zu dropped)", results.nbDroppedSamples);
+            }
+
+            if (ImGui::BeginTabBar("samplingProfilerTabs"))
+            {
+                if (ImGui::BeginTabItem("Top functions"))
+                {
+                    showTopFunctions(results, isSortNeeded);
+                    ImGui::EndTabItem();
+                }
+                if (ImGui::BeginTabItem("Flame graph"))
+                {
+                    showCallStacks(results);
+                    ImGui::EndTabItem();
+                }
+                ImGui::EndTabBar();
+            }
+        }
+        ImGui::End();
+    }
+
+} // namespace windows
@@ -0,0 +1,44 @@
+/******************************************************************************
+*                 SOFA, Simulation Open-Framework Architecture                *
+*                    (c) 2006 INRIA, USTL, UJF, CNRS, MGH                     *
+*                                                                             *
+* This program is free software; you can redistribute it and/or modify it     *
+* under the terms of the GNU General Public License as published by the Free  *
+* Software Foundation; either version 2 of the License, or (at your option)   *
+* any later version.                                                          *
+*                                                                             *
+* This program is distributed in the hope that it will be useful, but WITHOUT *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or       *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for    *
+* more details.                                                               *
+*                                                                             *
+* You should have received a copy of the GNU General Public License along     *
+* with this program. If not, see <http://www.gnu.org/licenses/>.              *
+*******************************************************************************
+* Authors: The SOFA Team and external contributors (see Authors.txt)          *
+*                                                                             *
+* Contact information: contact@sofa-framework.org                             *
+******************************************************************************/
+#pragma once
+
+#include <SofaImGui/SamplingProfiler.h>
+#include "WindowState.h"
+
+namespace windows
+{
+
+    /**
+     * @brief Shows the Sampling Profiler window.
+     *
+     * This function starts and stops the sampling of the main thread, and displays the functions in which most
+     * of the samples were taken, as well as a flame graph of the sampled call stacks.
+     *
+     * @param windowNameSamplingProfiler The name of the Sampling Profiler window.
+     * @param winManagerSamplingProfiler The state of the window (open or closed).
+     * @param samplingProfiler The profiler sampling the main thread. It is stopped when the window is closed.
+     */
+    void showSamplingProfiler(const char* const& windowNameSamplingProfiler,
+                              WindowState& winManagerSamplingProfiler,
+                              sofaimgui::SamplingProfiler& samplingProfiler);
+
+} // namespace windows
@@ -34,10 +34,13 @@
 #include <sofa/simulation/Node.h>
 #include <sofa/core/ObjectFactory.h>
 #include <SofaImGui/ObjectColor.h>
+#include <SofaImGui/ComponentCosts.h>
 #include <sofa/core/visual/VisualParams.h>
 #include <sofa/component/visual/LineAxis.h>
 #include <sofa/gui/common/BaseGUI.h>
 #include <sofa/simulation/graph/DAGNode.h>
+
+#include <algorithm>
 #include "SceneGraph.h"
 
 namespace windows
@@ -47,7 +50,9 @@ namespace windows
                         const char* const& windowNameSceneGraph,
                         std::set<sofa::core::objectmodel::BaseObject*>& openedComponents,
                         std::set<sofa::core::objectmodel::BaseObject*>& focusedComponents,
-                        WindowState& winManagerSceneGraph)
+                        WindowState& winManagerSceneGraph,
+                        sofa::core::objectmodel::BaseObject* hoveredObject,
+                        sofaimgui::ComponentCosts* componentCosts)
     {
         if (*winManagerSceneGraph.getStatePtr())
         {
@@ -63,21 +68,75 @@ namespace windows
                     showSearch = !showSearch;
                 }
 
+                if (componentCosts)
+                {
+                    ImGui::SameLine();
+                    if (ImGui::Button(ICON_FA_HOURGLASS))
+                    {
+                        componentCosts->setEnabled(!componentCosts->isEnabled());
+                    }
+                    if (ImGui::IsItemHovered())
+                    {
+                        ImGui::SetTooltip("Show the cost of the components, measured by the timers of the steps");
+                    }
+                }
+
                 static ImGuiTextFilter filter;
                 if (showSearch)
                 {
                     filter.Draw("Search");
                 }
 
+                const bool showCosts = componentCosts && componentCosts->isEnabled();
+                float rootCost {};
+                if (showCosts)
+                {
+                    componentCosts->update(groot.get());
+                    rootCost = componentCosts->getNodeCost(groot.get());
+                    ImGui::TextDisabled("%zu timer labels attributed to components, %.3f ms per step", componentCosts->getNbMappedLabels(), rootCost);
+                }
+
+                // the cell is colored from transparent yellow (cheap) to red (the most expensive)
+                const auto showCost = [](const float cost, const float maxCost)
+                {
+                    ImGui::TableNextColumn();
+                    if (cost <= 0.f)
+                    {
+                        return;
+                    }
+                    const float heat = maxCost > 0.f ? std::min(1.f, cost / maxCost) : 0.f;
+                    ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImGui::GetColorU32(ImVec4(1.f, 1.f - heat, 0.f, 0.1f + 0.5f * heat)));
+                    ImGui::Text("%.3f", cost);
+                };
+
                 unsigned int treeDepth {};
                 static sofa::core::objectmodel::Base* clickedObject { nullptr };
 
+                // a component newly hovered in the viewport is selected, and the nodes leading to it are opened
+                static const sofa::core::objectmodel::BaseObject* lastHoveredObject { nullptr };
+                static std::set<const sofa::simulation::Node*> hoveredPath;
+                const bool isNewlyHovered = hoveredObject != nullptr && hoveredObject != lastHoveredObject;
+                lastHoveredObject = hoveredObject;
+                if (isNewlyHovered)
+                {
+                    clickedObject = hoveredObject;
+                    hoveredPath.clear();
+                    auto* pathNode = dynamic_cast<sofa::simulation::Node*>(hoveredObject->getContext());
+                    while (pathNode)
+                    {
+                        hoveredPath.insert(pathNode);
+                        pathNode = dynamic_cast<sofa::simulation::Node*>(pathNode->getFirstParent());
+                    }
+                }
+
                 std::function<void(sofa::simulation::Node*)> showNode;
-                showNode = [&showNode, &treeDepth, expand, collapse, &openedComponents](sofa::simulation::Node* node)
+                showNode = [&showNode, &treeDepth, expand, collapse, &openedComponents, hoveredObject, isNewlyHovered, showCosts, componentCosts, rootCost, &showCost](sofa::simulation::Node* node)
                 {
                     if (node == nullptr) return;
                     if (treeDepth == 0)
                         ImGui::SetNextItemOpen(true, ImGuiCond_Once);
+                    if (isNewlyHovered && hoveredPath.count(node))
+                        ImGui::SetNextItemOpen(true);
                     if (expand)
                         ImGui::SetNextItemOpen(true);
                     if (collapse)
@@ -101,6 +160,11 @@ namespace windows
                     }
                     if (ImGui::IsItemClicked())
                         clickedObject = node;
+                    if (showCosts)
+                    {
+                        // total of the subtree
+                        showCost(componentCosts->getNodeCost(node), rootCost);
+                    }
                     if (open)
                     {
                         for (const auto object : node->getNodeObjects())
@@ -150,6 +214,13 @@ namespace windows
                                 objectColor = sofaimgui::getObjectColor(object);
                             }
 
+                            if (object == hoveredObject)
+                            {
+                                ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, IM_COL32(255, 255, 0, 60));
+                                if (isNewlyHovered)
+                                    ImGui::SetScrollHereY();
+                            }
+
                             ImGui::PushStyleColor(ImGuiCol_Text, objectColor);
                             const auto objectOpen = ImGui::TreeNodeEx(icon, objectFlags);
                             ImGui::PopStyleColor();
@@ -183,6 +254,11 @@ namespace windows
                                 ImGui::PopStyleColor();
                             }
 
+                            if (showCosts)
+                            {
+                                showCost(componentCosts->getObjectCost(object), componentCosts->getMaxObjectCost());
+                            }
+
                             if (objectOpen && !slaves.empty())
                             {
                                 for (const auto slave : slaves)
@@ -236,11 +312,15 @@ namespace windows
                 static ImGuiTableFlags flags = ImGuiTableFlags_ScrollY | ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_NoBordersInBody;
 
                 ImVec2 outer_size = ImVec2(0.0f, static_cast<bool>(clickedObject) * ImGui::GetTextLineHeightWithSpacing() * 20);
-                if (ImGui::BeginTable("sceneGraphTable", 2, flags, outer_size))
+                if (ImGui::BeginTable("sceneGraphTable", showCosts ? 3 : 2, flags, outer_size))
                 {
                     ImGui::TableSetupScrollFreeze(0, 1); // Make top row always visible
                     ImGui::TableSetupColumn("Name", ImGuiTableColumnFlags_NoHide);
                     ImGui::TableSetupColumn("Class Name", ImGuiTableColumnFlags_WidthFixed, ImGui::CalcTextSize("A").x * 12.0f);
+                    if (showCosts)
+                    {
+                        ImGui::TableSetupColumn("Cost (ms)", ImGuiTableColumnFlags_WidthFixed, ImGui::CalcTextSize("A").x * 9.0f);
+                    }
                     ImGui::TableHeadersRow();
 
                     showNode(groot.get());
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <sofa/simulation/Node.h>
+#include <SofaImGui/ComponentCosts.h>
 #include "WindowState.h"
 
 
@@ -37,12 +38,16 @@ namespace windows
          * @param isSceneGraphWindowOpen A reference to a boolean flag indicating if the Scene Graph window is open.
          * @param openedComponents A set containing pointers to the components that are currently opened and being inspected.
          * @param focusedComponents A set containing pointers to the components that are currently focused for inspection.
+         * @param hoveredObject The component under the cursor in the viewport, if any. It is highlighted and selected when it changes.
+         * @param componentCosts The costs of the components, displayed in a column when enabled from the window. No column if nullptr.
          */
         void showSceneGraph(sofa::core::sptr<sofa::simulation::Node> groot,
                             const char* const& windowNameSceneGraph,
                             std::set<sofa::core::objectmodel::BaseObject*>& openedComponents,
                             std::set<sofa::core::objectmodel::BaseObject*>& focusedComponents,
-                            WindowState& winManagerSceneGraph);
+                            WindowState& winManagerSceneGraph,
+                            sofa::core::objectmodel::BaseObject* hoveredObject = nullptr,
+                            sofaimgui::ComponentCosts* componentCosts = nullptr);
 
 
 } // namespace sofaimgui
@@ -30,6 +30,7 @@
 #include "Settings.h"
 
 #include <SofaImGui/UIStrings.h>
+#include <SofaImGui/LogStore.h>
 #include "SofaImGui/AppIniFile.h"
 
 namespace windows
@@ -88,6 +89,54 @@ namespace windows
                     [[maybe_unused]] SI_Error rc = ini.SaveFile(sofaimgui::AppIniFile::getAppIniFile().c_str());
                 }
 
+                bool renderViewportDirectly = ini.GetBoolValue("Visualization", "renderViewportDirectly", false);
+                if (ImGui::Checkbox("Render viewport directly", &renderViewportDirectly))
+                {
+                    ini.SetBoolValue("Visualization", "renderViewportDirectly", renderViewportDirectly);
+                    [[maybe_unused]] SI_Error rc = ini.SaveFile(sofaimgui::AppIniFile::getAppIniFile().c_str());
+                }
+                if (ImGui::IsItemHovered())
+                {
+                    ImGui::SetTooltip("Draw the scene straight into the viewport area of the window, without an intermediate framebuffer.\nSaves GPU memory and bandwidth, but the viewport cannot be detached from the main window.");
+                }
+
+                bool hoverPicking = ini.GetBoolValue("Visualization", "hoverPicking", false);
+                if (ImGui::Checkbox("Hover picking", &hoverPicking))
+                {
+                    ini.SetBoolValue("Visualization", "hoverPicking", hoverPicking);
+                    [[maybe_unused]] SI_Error rc = ini.SaveFile(sofaimgui::AppIniFile::getAppIniFile().c_str());
+                }
+                if (ImGui::IsItemHovered())
+                {
+                    ImGui::SetTooltip("Frame the visual model under the cursor in the viewport, and select it in the scene graph.");
+                }
+
+                int logMemoryCapacity = static_cast<int>(ini.GetLongValue("Log", "memoryCapacity", static_cast<long>(sofaimgui::LogStore::defaultMemoryCapacity)));
+                if (ImGui::InputInt("Log messages kept in memory", &logMemoryCapacity, 1000, 10000, ImGuiInputTextFlags_EnterReturnsTrue))
+                {
+                    logMemoryCapacity = std::max(logMemoryCapacity, 1000);
+                    sofaimgui::LogStore::getInstance().setMemoryCapacity(static_cast<std::size_t>(logMemoryCapacity));
+                    ini.SetLongValue("Log", "memoryCapacity", logMemoryCapacity);
+                    [[maybe_unused]] SI_Error rc = ini.SaveFile(sofaimgui::AppIniFile::getAppIniFile().c_str());
+                }
+                if (ImGui::IsItemHovered())
+                {
+                    ImGui::SetTooltip("The older messages are moved to a temporary file, and read back when they are displayed in the Log window.");
+                }
+
+                float logRateLimit = static_cast<float>(ini.GetDoubleValue("Log", "rateLimit", 0.));
+                if (ImGui::InputFloat("Log messages per second per sender", &logRateLimit, 10.f, 100.f, "%.0f", ImGuiInputTextFlags_EnterReturnsTrue))
+                {
+                    logRateLimit = std::max(logRateLimit, 0.f);
+                    sofaimgui::LogStore::getInstance().setRateLimit(static_cast<double>(logRateLimit));
+                    ini.SetDoubleValue("Log", "rateLimit", static_cast<double>(logRateLimit));
+                    [[maybe_unused]] SI_Error rc = ini.SaveFile(sofaimgui::AppIniFile::getAppIniFile().c_str());
+                }
+                if (ImGui::IsItemHovered())
+                {
+                    ImGui::SetTooltip("Beyond this rate, the messages of a sender are dropped before being stored (0: no limit).\nErrors are never dropped.");
+                }
+
                 bool showViewportSettingsButton = ini.GetBoolValue("Visualization", "showViewportSettingsButton", true);
                 if (ImGui::Checkbox("Show viewport settings button", &showViewportSettingsButton))
                 {
@@ -29,9 +29,13 @@
 #include <sofa/component/visual/LineAxis.h>
 #include <sofa/gl/component/rendering3d/OglSceneFrame.h>
 #include <sofa/gui/common/BaseGUI.h>
+#include <sofa/core/visual/VisualParams.h>
+#include <sofa/gl/gl.h>
+#include <sofa/gl/glu.h>
 #include "ViewPort.h"
 #include "SofaGLFW/SofaGLFWBaseGUI.h"
 #include <iomanip>
+#include <limits>
 namespace windows
 {
 
@@ -39,21 +43,32 @@ namespace windows
                       const char* const& windowNameViewport,
                       const CSimpleIniA &ini,
                       std::unique_ptr<sofa::gl::FrameBufferObject>& m_fbo,
+                      const bool renderDirectly,
                       std::pair<float, float>& m_viewportWindowSize,
+                      std::pair<float, float>& m_viewportWindowPosition,
                       bool &isMouseOnViewport,
                       WindowState& winManagerViewPort,
                       sofaglfw::SofaGLFWBaseGUI* baseGUI,
                       bool& isViewportDisplayedForTheFirstTime,
-                      sofa::type::Vec2f& lastViewPortPos)
+                      sofa::type::Vec2f& lastViewPortPos,
+                      sofaimgui::HoverPicker* hoverPicker)
     {
         if (*winManagerViewPort.getStatePtr())
         {
             ImVec2 pos;
-            if (ImGui::Begin(windowNameViewport, winManagerViewPort.getStatePtr()/*, ImGuiWindowFlags_MenuBar*/))
+            ImGuiWindowFlags viewportFlags = ImGuiWindowFlags_None;
+            if (renderDirectly)
+            {
+                // the scene is drawn in the backbuffer of the main window, under the ImGui windows
+                ImGui::SetNextWindowViewport(ImGui::GetMainViewport()->ID);
+                viewportFlags |= ImGuiWindowFlags_NoBackground;
+            }
+
+            if (ImGui::Begin(windowNameViewport, winManagerViewPort.getStatePtr(), viewportFlags/* | ImGuiWindowFlags_MenuBar*/))
             {
                 pos = ImGui::GetWindowPos();
 
-                ImGui::BeginChild("Render");
+                ImGui::BeginChild("Render", ImVec2(0, 0), false, viewportFlags);
                 ImVec2 wsize = ImGui::GetWindowSize();
                 m_viewportWindowSize = { wsize.x, wsize.y};
 
@@ -73,9 +88,21 @@ namespace windows
                     lastViewPortPos.y() = viewportPos.y;
                 }
 
-                ImGui::Image((ImTextureID)m_fbo->getColorTexture(), wsize, ImVec2(0, 1), ImVec2(1, 0));
+                if (renderDirectly)
+                {
+                    m_viewportWindowPosition = { viewportPos.x, viewportPos.y };
+                    ImGui::Dummy(wsize);
+                }
+                else if (m_fbo)
+                {
+                    ImGui::Image((ImTextureID)m_fbo->getColorTexture(), wsize, ImVec2(0, 1), ImVec2(1, 0));
+                }
 
                 isMouseOnViewport = ImGui::IsItemHovered();
+                if (hoverPicker)
+                {
+                    showHoveredObject(groot, *hoverPicker, isMouseOnViewport, viewportPos);
+                }
                 ImGui::EndChild();
 
             }
@@ -162,6 +189,66 @@ namespace windows
 
     }
 
+    void showHoveredObject(sofa::core::sptr<sofa::simulation::Node> groot,
+                           sofaimgui::HoverPicker& hoverPicker,
+                           const bool isMouseOnViewport,
+                           const ImVec2& viewportPos)
+    {
+        const auto* vparams = sofa::core::visual::VisualParams::defaultInstance();
+        const auto& viewport = vparams->viewport();
+        double projectionMatrix[16];
+        double modelviewMatrix[16];
+        vparams->getProjectionMatrix(projectionMatrix);
+        vparams->getModelViewMatrix(modelviewMatrix);
+
+        if (!isMouseOnViewport || ImGui::IsMouseDragging(ImGuiMouseButton_Left) || ImGui::IsMouseDragging(ImGuiMouseButton_Right))
+        {
+            hoverPicker.resetHover();
+            return;
+        }
+
+        // ray through the cursor, from the near plane to the far plane
+        const ImVec2 mousePos = ImGui::GetMousePos();
+        const double windowX = viewport[0] + (mousePos.x - viewportPos.x);
+        const double windowY = viewport[1] + viewport[3] - 1 - (mousePos.y - viewportPos.y);
+        sofa::type::Vec3d nearPoint;
+        sofa::type::Vec3d farPoint;
+        gluUnProject(windowX, windowY, 0, modelviewMatrix, projectionMatrix, viewport.data(), &nearPoint[0], &nearPoint[1], &nearPoint[2]);
+        gluUnProject(windowX, windowY, 1, modelviewMatrix, projectionMatrix, viewport.data(), &farPoint[0], &farPoint[1], &farPoint[2]);
+        hoverPicker.requestPick(groot.get(), nearPoint, farPoint - nearPoint);
+
+        const auto* hoveredObject = hoverPicker.getHoveredObject();
+        if (!hoveredObject)
+        {
+            return;
+        }
+
+        // frame the hovered object with the screen projection of its bounding box
+        const auto& boundingBox = hoverPicker.getHoveredBoundingBox();
+        const auto& minBBox = boundingBox.minBBox();
+        const auto& maxBBox = boundingBox.maxBBox();
+        ImVec2 frameMin(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+        ImVec2 frameMax(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+        for (unsigned int corner = 0; corner < 8; ++corner)
+        {
+            double projected[3];
+            gluProject(corner & 1 ? maxBBox[0] : minBBox[0],
+                       corner & 2 ? maxBBox[1] : minBBox[1],
+                       corner & 4 ? maxBBox[2] : minBBox[2],
+                       modelviewMatrix, projectionMatrix, viewport.data(), &projected[0], &projected[1], &projected[2]);
+            const float x = viewportPos.x + static_cast<float>(projected[0] - viewport[0]);
+            const float y = viewportPos.y + static_cast<float>(viewport[1] + viewport[3] - 1 - projected[1]);
+            frameMin = ImVec2(std::min(frameMin.x, x), std::min(frameMin.y, y));
+            frameMax = ImVec2(std::max(frameMax.x, x), std::max(frameMax.y, y));
+        }
+        ImGui::GetWindowDrawList()->AddRect(frameMin, frameMax, IM_COL32(255, 255, 0, 255));
+
+        ImGui::BeginTooltip();
+        ImGui::Text("%s", hoveredObject->getName().c_str());
+        ImGui::TextDisabled("%s", hoveredObject->getClassName().c_str());
+        ImGui::EndTooltip();
+    }
+
     bool hasViewportMoved(const float currentX, const float currentY, const float lastX, const float lastY, const float threshold)
     {
         return std::fabs(currentX - lastX) > threshold || std::fabs(currentY - lastY) > threshold;
@@ -22,6 +22,8 @@
 #pragma once
 
 #include <sofa/simulation/Node.h>
+#include <SofaImGui/HoverPicker.h>
+#include <imgui.h>
 #include "WindowState.h"
 
 namespace windows
@@ -31,29 +33,52 @@ namespace windows
          * @brief Displays the viewport window.
          *
          * This function renders the viewport window, showing the scene rendered into a frame buffer object (FBO).
+         * In direct mode, the scene has already been drawn in the backbuffer: the window is transparent and kept in the main viewport.
          * It also provides options to show/hide grid, axis, and frame within the viewport.
+         * If hover picking is enabled, the visual model under the cursor is framed in the viewport.
          *
          * @param groot The root node of the scene to be rendered.
          * @param windowNameViewport The name of the viewport window.
          * @param ini The INI file object containing application settings.
          * @param m_fbo The frame buffer object (FBO) used for rendering the scene.
+         * @param renderDirectly A boolean indicating if the scene is rendered directly in the backbuffer instead of the FBO.
          * @param m_viewportWindowSize A reference to a pair representing the width and height of the viewport window.
+         * @param m_viewportWindowPosition A reference to a pair representing the position of the rendering area of the viewport window.
          * @param isMouseOnViewport A reference to a boolean flag indicating if the mouse cursor is over the viewport.
          * @param winManagerViewPort The state manager for the viewport window.
          * @param baseGUI A pointer to the base GUI object.
          * @param isViewportDisplayedForTheFirstTime A reference to a boolean indicating if this is the first time the viewport is being displayed.
          * @param lastViewPortPos A reference to the last recorded position of the viewport.
+         * @param hoverPicker The picker finding the component under the cursor, or nullptr if hover picking is disabled.
          */
         void showViewPort(sofa::core::sptr<sofa::simulation::Node> groot,
                           const char* const& windowNameViewport,
                           const CSimpleIniA &ini,
                           std::unique_ptr<sofa::gl::FrameBufferObject>& m_fbo,
+                          bool renderDirectly,
                           std::pair<float, float>& m_viewportWindowSize,
+                          std::pair<float, float>& m_viewportWindowPosition,
                           bool & isMouseOnViewport,
                           WindowState& winManagerViewPort,
                           sofaglfw::SofaGLFWBaseGUI* baseGUI,
                           bool& isViewportDisplayedForTheFirstTime,
-                          sofa::type::Vec2f& lastViewPortPos);
+                          sofa::type::Vec2f& lastViewPortPos,
+                          sofaimgui::HoverPicker* hoverPicker);
+
+        /**
+         * @brief Sends the hover pick requests and frames the component under the cursor.
+         *
+         * Must be called inside the child window containing the rendered scene.
+         *
+         * @param groot The root node of the scene.
+         * @param hoverPicker The picker finding the component under the cursor.
+         * @param isMouseOnViewport A boolean indicating if the mouse cursor is over the viewport.
+         * @param viewportPos The screen position of the rendered scene.
+         */
+        void showHoveredObject(sofa::core::sptr<sofa::simulation::Node> groot,
+                               sofaimgui::HoverPicker& hoverPicker,
+                               bool isMouseOnViewport,
+                               const ImVec2& viewportPos);
 
         /**
          * @brief Checks if the viewport position has moved beyond a specified threshold.
@@ -51,6 +51,10 @@ int main(int argc, char** argv)
         ("l,load", "load given plugins as a comma-separated list. Example: -l SofaPython3", cxxopts::value<std::vector<std::string> >(pluginsToLoad))
         ("m,msaa_samples", "set number of samples for multisample anti-aliasing (MSAA)", cxxopts::value<unsigned short>()->default_value("0"))
         ("n,nb_iterations", "set number of iterations to run (batch mode)", cxxopts::value<std::size_t>()->default_value("0"))
+        ("profile-out", "write the AdvancedTimer records of each time step in a Chrome Trace / Perfetto JSON file. Example: --profile-out trace.json", cxxopts::value<std::string>())
+        ("profile", "record the AdvancedTimer records of each time step in a binary file and print a summary of the timers at exit. Example: --profile run.sofaprof", cxxopts::value<std::string>())
+        ("log-file", "write the messages of the log in a text file as they are sent, from a background thread. Example: --log-file run.log", cxxopts::value<std::string>())
+        ("metrics", "publish live metrics of the run (frame rate, step and draw durations, memory, messages, simulated time), served over HTTP for Prometheus or sent to a statsd daemon. Examples: --metrics prometheus://9100, --metrics statsd://localhost:8125", cxxopts::value<std::string>())
         ("h,help", "print usage")
         ;
 
@@ -72,6 +76,30 @@ int main(int argc, char** argv)
     // create an instance of SofaGLFWGUI
     // linked with the simulation
     sofaglfw::SofaGLFWBaseGUI glfwGUI;
+
+    // as early as possible, to write the messages of the loading of the plugins and of the scene
+    if (result.count("log-file") && !glfwGUI.setLogFile(result["log-file"].as<std::string>()))
+    {
+        std::cerr << "Could not open the log file, quitting..." << std::endl;
+        return 1;
+    }
+
+    // the outputs requested are checked before loading the scene: a batch run without them would be wasted
+    if (result.count("profile-out") && !glfwGUI.setTraceFile(result["profile-out"].as<std::string>()))
+    {
+        std::cerr << "Could not open the trace file, quitting..." << std::endl;
+        return 1;
+    }
+    if (result.count("profile") && !glfwGUI.setProfileFile(result["profile"].as<std::string>()))
+    {
+        std::cerr << "Could not open the profiling file, quitting..." << std::endl;
+        return 1;
+    }
+    if (result.count("metrics") && !glfwGUI.setMetricsEndpoint(result["metrics"].as<std::string>()))
+    {
+        std::cerr << "Could not publish the metrics, quitting..." << std::endl;
+        return 1;
+    }
     
     auto nbMSAASamples = result["msaa_samples"].as<unsigned short>();
     if (!glfwGUI.init(nbMSAASamples))